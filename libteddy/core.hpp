@@ -1,8 +1,11 @@
 #ifndef LIBTEDDY_CORE_HPP
 #define LIBTEDDY_CORE_HPP
 
+#include <libteddy/details/add_manager.hpp>
+#include <libteddy/details/cbdd_manager.hpp>
 #include <libteddy/details/diagram_manager.hpp>
 #include <libteddy/details/pla_file.hpp>
+#include <libteddy/details/zdd_manager.hpp>
 
 namespace teddy
 {
@@ -182,6 +185,253 @@ struct ifmdd_manager :
     );
 };
 
+/**
+ *  \class bzdd_manager
+ *  \brief Diagram manager for Zero-suppressed Binary Decision Diagrams
+ *
+ *  Diagrams represent families of sets, e.g., cut sets of a BSS.
+ */
+struct bzdd_manager :
+    public zdd_manager<degrees::fixed<2>, domains::fixed<2>>
+{
+    /**
+     *  \brief Initializes ZBDD manager.
+     *
+     *  \param varCount Number of variables.
+     *  \param nodePoolSize Size of the main node pool.
+     *  \param order Order of variables. Variables are ordered
+     *  by their indices by default.
+     */
+    bzdd_manager(
+        int32 varCount,
+        int64 nodePoolSize,
+        std::vector<int32> order = default_oder()
+    );
+
+    /**
+     *  \brief Initializes ZBDD manager.
+     *
+     *  \param varCount Number of variables.
+     *  \param nodePoolSize Size of the main node pool.
+     *  \param overflowNodePoolSize Size of the additional node pools.
+     *  \param order Order of variables. Variables are ordered
+     *  by their indices by default.
+     */
+    bzdd_manager(
+        int32 varCount,
+        int64 nodePoolSize,
+        int64 overflowNodePoolSize,
+        std::vector<int32> order = default_oder()
+    );
+};
+
+/**
+ *  \class mzdd_manager
+ *  \brief Diagram manager for Zero-suppressed Multi-valued Decision Diagrams
+ *
+ *  Diagrams represent families of vectors, e.g., cut vectors of a MSS.
+ *
+ *  \tparam M domain of variables
+ */
+template<int32 M>
+struct mzdd_manager :
+    public zdd_manager<degrees::fixed<M>, domains::fixed<M>>
+{
+    /**
+     *  \brief Initializes ZMDD manager
+     *  \param varCount Number of variables
+     *  \param nodePoolSize Size of the main node pool
+     *  \param order Order of variables. Variables are ordered
+     *  by their indices by default
+     */
+    mzdd_manager(
+        int32 varCount,
+        int64 nodePoolSize,
+        std::vector<int32> order = default_oder()
+    );
+
+    /**
+     *  \brief Initializes ZMDD manager
+     *  \param varCount Number of variables
+     *  \param nodePoolSize Size of the main node pool
+     *  \param overflowNodePoolSize Size of the additional node pools
+     *  \param order Order of variables. Variables are ordered
+     *  by their indices by default.
+     */
+    mzdd_manager(
+        int32 varCount,
+        int64 nodePoolSize,
+        int64 overflowNodePoolSize,
+        std::vector<int32> order = default_oder()
+    );
+};
+
+/**
+ *  \class izdd_manager
+ *  \brief Diagram manager for Zero-suppressed (integer) Multi-valued
+ *  Decision Diagrams
+ *
+ *  Unlike \c mzdd_manager variables can have different domains.
+ */
+struct izdd_manager : public zdd_manager<degrees::mixed, domains::mixed>
+{
+    /**
+     *  \brief Initializes iZMDD manager
+     *  \param varCount Number of variables
+     *  \param nodePoolSize Size of the main node pool
+     *  \param domains Domains of variables
+     *  Number at index i is the domain of i-th variable.
+     *  \param order Order of variables. Variables are ordered
+     *  by their indices by default
+     */
+    izdd_manager(
+        int32 varCount,
+        int64 nodePoolSize,
+        std::vector<int32> domains,
+        std::vector<int32> order = default_oder()
+    );
+
+    /**
+     *  \brief Initializes iZMDD manager
+     *  \param varCount Number of variables
+     *  \param nodePoolSize Size of the main node pool
+     *  \param overflowNodePoolSize Size of the additional node pools
+     *  \param domains Domains of variables
+     *  Number at index i is the domain of i-th variable.
+     *  \param order Order of variables. Variables are ordered
+     *  by their indices by default
+     */
+    izdd_manager(
+        int32 varCount,
+        int64 nodePoolSize,
+        int64 overflowNodePoolSize,
+        std::vector<int32> domains,
+        std::vector<int32> order = default_oder()
+    );
+};
+
+/**
+ *  \class badd_manager
+ *  \brief Diagram manager for Algebraic Decision Diagrams
+ *  of binary variables
+ */
+struct badd_manager :
+    public add_manager<degrees::fixed<2>, domains::fixed<2>>
+{
+    /**
+     *  \brief Initializes ADD manager.
+     *
+     *  \param varCount Number of variables.
+     *  \param nodePoolSize Size of the main node pool.
+     *  \param order Order of variables. Variables are ordered
+     *  by their indices by default.
+     */
+    badd_manager(
+        int32 varCount,
+        int64 nodePoolSize,
+        std::vector<int32> order = default_oder()
+    );
+
+    /**
+     *  \brief Initializes ADD manager.
+     *
+     *  \param varCount Number of variables.
+     *  \param nodePoolSize Size of the main node pool.
+     *  \param overflowNodePoolSize Size of the additional node pools.
+     *  \param order Order of variables. Variables are ordered
+     *  by their indices by default.
+     */
+    badd_manager(
+        int32 varCount,
+        int64 nodePoolSize,
+        int64 overflowNodePoolSize,
+        std::vector<int32> order = default_oder()
+    );
+};
+
+/**
+ *  \class madd_manager
+ *  \brief Diagram manager for Algebraic Decision Diagrams
+ *  of multi-valued variables
+ *  \tparam M domain of variables
+ */
+template<int32 M>
+struct madd_manager :
+    public add_manager<degrees::fixed<M>, domains::fixed<M>>
+{
+    /**
+     *  \brief Initializes ADD manager
+     *  \param varCount Number of variables
+     *  \param nodePoolSize Size of the main node pool
+     *  \param order Order of variables. Variables are ordered
+     *  by their indices by default
+     */
+    madd_manager(
+        int32 varCount,
+        int64 nodePoolSize,
+        std::vector<int32> order = default_oder()
+    );
+
+    /**
+     *  \brief Initializes ADD manager
+     *  \param varCount Number of variables
+     *  \param nodePoolSize Size of the main node pool
+     *  \param overflowNodePoolSize Size of the additional node pools
+     *  \param order Order of variables. Variables are ordered
+     *  by their indices by default.
+     */
+    madd_manager(
+        int32 varCount,
+        int64 nodePoolSize,
+        int64 overflowNodePoolSize,
+        std::vector<int32> order = default_oder()
+    );
+};
+
+/**
+ *  \class iadd_manager
+ *  \brief Diagram manager for Algebraic Decision Diagrams
+ *  of (integer) multi-valued variables
+ *
+ *  Unlike \c madd_manager variables can have different domains.
+ */
+struct iadd_manager : public add_manager<degrees::mixed, domains::mixed>
+{
+    /**
+     *  \brief Initializes iADD manager
+     *  \param varCount Number of variables
+     *  \param nodePoolSize Size of the main node pool
+     *  \param domains Domains of variables
+     *  Number at index i is the domain of i-th variable.
+     *  \param order Order of variables. Variables are ordered
+     *  by their indices by default
+     */
+    iadd_manager(
+        int32 varCount,
+        int64 nodePoolSize,
+        std::vector<int32> domains,
+        std::vector<int32> order = default_oder()
+    );
+
+    /**
+     *  \brief Initializes iADD manager
+     *  \param varCount Number of variables
+     *  \param nodePoolSize Size of the main node pool
+     *  \param overflowNodePoolSize Size of the additional node pools
+     *  \param domains Domains of variables
+     *  Number at index i is the domain of i-th variable.
+     *  \param order Order of variables. Variables are ordered
+     *  by their indices by default
+     */
+    iadd_manager(
+        int32 varCount,
+        int64 nodePoolSize,
+        int64 overflowNodePoolSize,
+        std::vector<int32> domains,
+        std::vector<int32> order = default_oder()
+    );
+};
+
 inline bdd_manager::bdd_manager(
     int32 const varCount,
     int64 const nodePoolSize,
@@ -309,6 +559,190 @@ ifmdd_manager<PMax>::ifmdd_manager(
     )
 {
 }
+inline bzdd_manager::bzdd_manager(
+    int32 const varCount,
+    int64 const nodePoolSize,
+    std::vector<int32> order
+) :
+    bzdd_manager(
+        varCount,
+        nodePoolSize,
+        nodePoolSize / 2,
+        static_cast<std::vector<int32>&&>(order)
+    )
+{
+}
+
+inline bzdd_manager::bzdd_manager(
+    int32 const varCount,
+    int64 const nodePoolSize,
+    int64 const overflowNodePoolSize,
+    std::vector<int32> order
+) :
+    zdd_manager<degrees::fixed<2>, domains::fixed<2>>(
+        varCount,
+        nodePoolSize,
+        overflowNodePoolSize,
+        static_cast<std::vector<int32>&&>(order)
+    )
+{
+}
+
+template<int32 M>
+mzdd_manager<M>::mzdd_manager(
+    int32 const varCount,
+    int64 const nodePoolSize,
+    std::vector<int32> order
+) :
+    mzdd_manager(
+        varCount,
+        nodePoolSize,
+        nodePoolSize / 2,
+        static_cast<std::vector<int32>&&>(order)
+    )
+{
+}
+
+template<int32 M>
+mzdd_manager<M>::mzdd_manager(
+    int32 const varCount,
+    int64 const nodePoolSize,
+    int64 const overflowNodePoolSize,
+    std::vector<int32> order
+) :
+    zdd_manager<degrees::fixed<M>, domains::fixed<M>>(
+        varCount,
+        nodePoolSize,
+        overflowNodePoolSize,
+        static_cast<std::vector<int32>&&>(order)
+    )
+{
+}
+
+inline izdd_manager::izdd_manager(
+    int32 const varCount,
+    int64 const nodePoolSize,
+    std::vector<int32> domains,
+    std::vector<int32> order
+) :
+    izdd_manager(
+        varCount,
+        nodePoolSize,
+        nodePoolSize / 2,
+        static_cast<std::vector<int32>&&>(domains),
+        static_cast<std::vector<int32>&&>(order)
+    )
+{
+}
+
+inline izdd_manager::izdd_manager(
+    int32 const varCount,
+    int64 const nodePoolSize,
+    int64 const overflowNodePoolSize,
+    std::vector<int32> domains,
+    std::vector<int32> order
+) :
+    zdd_manager<degrees::mixed, domains::mixed>(
+        varCount,
+        nodePoolSize,
+        overflowNodePoolSize,
+        static_cast<std::vector<int32>&&>(domains),
+        static_cast<std::vector<int32>&&>(order)
+    )
+{
+}
+inline badd_manager::badd_manager(
+    int32 const varCount,
+    int64 const nodePoolSize,
+    std::vector<int32> order
+) :
+    badd_manager(
+        varCount,
+        nodePoolSize,
+        nodePoolSize / 2,
+        static_cast<std::vector<int32>&&>(order)
+    )
+{
+}
+
+inline badd_manager::badd_manager(
+    int32 const varCount,
+    int64 const nodePoolSize,
+    int64 const overflowNodePoolSize,
+    std::vector<int32> order
+) :
+    add_manager<degrees::fixed<2>, domains::fixed<2>>(
+        varCount,
+        nodePoolSize,
+        overflowNodePoolSize,
+        static_cast<std::vector<int32>&&>(order)
+    )
+{
+}
+
+template<int32 M>
+madd_manager<M>::madd_manager(
+    int32 const varCount,
+    int64 const nodePoolSize,
+    std::vector<int32> order
+) :
+    madd_manager(
+        varCount,
+        nodePoolSize,
+        nodePoolSize / 2,
+        static_cast<std::vector<int32>&&>(order)
+    )
+{
+}
+
+template<int32 M>
+madd_manager<M>::madd_manager(
+    int32 const varCount,
+    int64 const nodePoolSize,
+    int64 const overflowNodePoolSize,
+    std::vector<int32> order
+) :
+    add_manager<degrees::fixed<M>, domains::fixed<M>>(
+        varCount,
+        nodePoolSize,
+        overflowNodePoolSize,
+        static_cast<std::vector<int32>&&>(order)
+    )
+{
+}
+
+inline iadd_manager::iadd_manager(
+    int32 const varCount,
+    int64 const nodePoolSize,
+    std::vector<int32> domains,
+    std::vector<int32> order
+) :
+    iadd_manager(
+        varCount,
+        nodePoolSize,
+        nodePoolSize / 2,
+        static_cast<std::vector<int32>&&>(domains),
+        static_cast<std::vector<int32>&&>(order)
+    )
+{
+}
+
+inline iadd_manager::iadd_manager(
+    int32 const varCount,
+    int64 const nodePoolSize,
+    int64 const overflowNodePoolSize,
+    std::vector<int32> domains,
+    std::vector<int32> order
+) :
+    add_manager<degrees::mixed, domains::mixed>(
+        varCount,
+        nodePoolSize,
+        overflowNodePoolSize,
+        static_cast<std::vector<int32>&&>(domains),
+        static_cast<std::vector<int32>&&>(order)
+    )
+{
+}
 } // namespace teddy
 
 #endif
\ No newline at end of file
@@ -0,0 +1,963 @@
+#ifndef LIBTEDDY_DETAILS_ADD_MANAGER_HPP
+#define LIBTEDDY_DETAILS_ADD_MANAGER_HPP
+
+#include <libteddy/details/diagram.hpp>
+#include <libteddy/details/diagram_manager.hpp>
+#include <libteddy/details/node_manager.hpp>
+#include <libteddy/details/operators.hpp>
+#include <libteddy/details/probabilities.hpp>
+#include <libteddy/details/tools.hpp>
+#include <libteddy/details/types.hpp>
+
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace teddy
+{
+namespace real_ops
+{
+struct PLUS : details::operation_info<30, true>
+{
+    [[nodiscard]] auto constexpr operator() (double const l, double const r)
+        const -> double
+    {
+        return l + r;
+    }
+};
+
+struct MINUS : details::operation_info<31, false>
+{
+    [[nodiscard]] auto constexpr operator() (double const l, double const r)
+        const -> double
+    {
+        return l - r;
+    }
+};
+
+struct TIMES : details::operation_info<32, true>
+{
+    [[nodiscard]] auto constexpr operator() (double const l, double const r)
+        const -> double
+    {
+        return l * r;
+    }
+};
+
+struct MIN : details::operation_info<33, true>
+{
+    [[nodiscard]] auto constexpr operator() (double const l, double const r)
+        const -> double
+    {
+        return l < r ? l : r;
+    }
+};
+
+struct MAX : details::operation_info<34, true>
+{
+    [[nodiscard]] auto constexpr operator() (double const l, double const r)
+        const -> double
+    {
+        return l < r ? r : l;
+    }
+};
+} // namespace real_ops
+
+/**
+ *  \class add_manager
+ *  \brief Base class for managers of Algebraic Decision Diagrams
+ *
+ *  Diagram represents a real-valued function of discrete variables.
+ *  Terminal nodes store an index into the table of values that is
+ *  kept by the manager, so that each value has a unique terminal node.
+ *  Operations from \c teddy::real_ops can be applied to the diagrams.
+ *
+ *  Values are looked up by their rounding to the number of significant
+ *  bits set by \c set_value_precision so that results that differ only
+ *  by rounding errors, e.g., 0.1 + 0.2 and 0.3, share the terminal and
+ *  diagrams stay canonical. The terminal keeps the first value that was
+ *  looked up. Values that lie close to opposite sides of a rounding
+ *  boundary can still get different terminals. All NaNs share a single
+ *  terminal. Values that are no longer used by any diagram are dropped
+ *  by \c force_gc .
+ *
+ *  Typical use is to convert a structure function to the indicator of
+ *  a system state and to average out components whose state is not
+ *  of interest. The result is the availability as a function of the
+ *  states of the remaining components that can be queried repeatedly.
+ *
+ *  \tparam Degree Node degree
+ *  \tparam Domain Variable domains
+ */
+template<class Degree, class Domain>
+class add_manager
+{
+public:
+    /**
+     *  \brief Alias for the diagram type used in the
+     *  functions of this manager.
+     */
+    using diagram_t = diagram<void, Degree>;
+
+public:
+    /**
+     *  \brief Creates diagram representing constant function
+     *  \param value Value of the constant function
+     *  \return Diagram representing constant function
+     */
+    auto constant (double value) -> diagram_t;
+
+    /**
+     *  \brief Creates diagram representing function of single variable
+     *
+     *  Value of the function is the value of the variable.
+     *
+     *  \param index Index of the variable
+     *  \return Diagram of a function of single variable
+     */
+    auto variable (int32 index) -> diagram_t;
+
+    /**
+     *  \brief Converts decision diagram to real-valued diagram
+     *
+     *  Manager of the diagram must have the same number of variables,
+     *  the same domains and the same order of variables.
+     *
+     *  \param manager Manager of the \p diagram
+     *  \param diagram Decision diagram
+     *  \return Diagram representing the same function
+     */
+    template<class Data, class D, class Dm>
+    auto from_diagram (
+        diagram_manager<Data, D, Dm> const& manager,
+        diagram<Data, D> const& diagram
+    ) -> diagram_t;
+
+    /**
+     *  \brief Converts decision diagram to real-valued diagram
+     *
+     *  Manager of the diagram must have the same number of variables,
+     *  the same domains and the same order of variables.
+     *
+     *  \tparam F Function object type
+     *  \param manager Manager of the \p diagram
+     *  \param diagram Decision diagram
+     *  \param transformer Maps values of the function to real values
+     *  \return Diagram representing composition of \p transformer
+     *  and the function
+     */
+    template<class Data, class D, class Dm, class F>
+    auto from_diagram (
+        diagram_manager<Data, D, Dm> const& manager,
+        diagram<Data, D> const& diagram,
+        F transformer
+    ) -> diagram_t;
+
+    /**
+     *  \brief Merges two diagrams using given binary operation.
+     *  \tparam Op Binary operation from \c teddy::real_ops
+     *  \param lhs first diagram
+     *  \param rhs second diagram
+     *  \return Diagram representing merger of \p lhs and \p rhs
+     */
+    template<teddy_bin_op Op>
+    auto apply (diagram_t const& lhs, diagram_t const& rhs) -> diagram_t;
+
+    /**
+     *  \brief Calculates cofactor of the function
+     *  \param diagram Diagram representing the function
+     *  \param varIndex Index of the variable
+     *  \param varValue Value of the variable
+     *  \return Diagram representing the cofactor
+     */
+    auto get_cofactor (diagram_t const& diagram, int32 varIndex, int32 varValue)
+        -> diagram_t;
+
+    /**
+     *  \brief Averages out the variable from the function
+     *
+     *  \p probs[i][k] must return probability that i-th variable has
+     *  value k. Result is the expected value of the function w.r.t. the
+     *  variable \p varIndex as a function of the remaining variables.
+     *
+     *  \tparam Ps Type that holds probabilities of variables
+     *  \param probs matrix of probabilities
+     *  \param diagram Diagram representing the function
+     *  \param varIndex Index of the variable
+     *  \return Diagram representing the averaged function
+     */
+    template<probs::prob_matrix Ps>
+    auto average (Ps const& probs, diagram_t const& diagram, int32 varIndex)
+        -> diagram_t;
+
+    /**
+     *  \brief Calculates expected value of the function
+     *
+     *  \p probs[i][k] must return probability that i-th variable has
+     *  value k. Complexity is \c O(|d|) where \c |d| is the number
+     *  of nodes.
+     *
+     *  \tparam Ps Type that holds probabilities of variables
+     *  \param probs matrix of probabilities
+     *  \param diagram Diagram representing the function
+     *  \return Expected value of the function
+     */
+    template<probs::prob_matrix Ps>
+    auto expected_value (Ps const& probs, diagram_t const& diagram) const
+        -> double;
+
+    /**
+     *  \brief Calculates expected value of the function of binary variables
+     *
+     *  \p probs[i] must return probability that i-th variable is 1.
+     *
+     *  \tparam Ps Type that holds probabilities of variables
+     *  \param probs vector of probabilities
+     *  \param diagram Diagram representing the function
+     *  \return Expected value of the function
+     */
+    template<probs::prob_vector Ps>
+    auto expected_value (Ps const& probs, diagram_t const& diagram) const
+        -> double;
+
+    /**
+     *  \brief Evaluates value of the function represented by the diagram
+     *
+     *  Complexity is \c O(n) where \c n is the number of variables.
+     *
+     *  \tparam Vars Container type that defines operator[] and returns
+     *  value convertible to int
+     *  \param diagram Diagram
+     *  \param values Container holding values of variables
+     *  \return Value of the function for variable values given in \p values
+     */
+    template<in_var_values Vars>
+    auto evaluate (diagram_t const& diagram, Vars const& values) const
+        -> double;
+
+    /**
+     *  \brief Returns number of nodes that are currently
+     *  used by the manager.
+     *  \return Number of nodes
+     */
+    [[nodiscard]] auto get_node_count () const -> int64;
+
+    /**
+     *  \brief Returns number of nodes in the diagram including
+     *  terminal nodes
+     *  \param diagram Diagram
+     *  \return Number of node
+     */
+    auto get_node_count (diagram_t const& diagram) const -> int64;
+
+    /**
+     *  \brief Runs garbage collection.
+     */
+    auto force_gc () -> void;
+
+    /**
+     *  \brief Clears apply cache.
+     */
+    auto clear_cache () -> void;
+
+    /**
+     *  \brief Returns number of variables for this manager
+     *  set in the constructor.
+     *  \return Number of variables.
+     */
+    [[nodiscard]] auto get_var_count () const -> int32;
+
+    /**
+     *  \brief Returns order of variables.
+     *  \return Vector of indices. Index at l-th position is the
+     *  index of variable at l-th level of the diagram.
+     */
+    [[nodiscard]] auto get_order () const -> std::vector<int32> const&;
+
+    /**
+     *  \brief Returns domains of variables.
+     *  \return Vector of domains.
+     */
+    [[nodiscard]] auto get_domains () const -> std::vector<int32>;
+
+    /**
+     *  \brief Sets the relative cache size w.r.t the number of nodes
+     *  \param ratio Number from the interval (0,oo)
+     */
+    auto set_cache_ratio (double ratio) -> void;
+
+    /**
+     *  \brief Sets ratio used to determine new node pool allocation
+     *  \param ratio Number from the interval [0,1]
+     */
+    auto set_gc_ratio (double ratio) -> void;
+
+    /**
+     *  \brief Sets the number of significant bits of terminal values
+     *
+     *  Applies to values created after the call. The default is
+     *  \c DefaultValuePrecision , 52 keeps values exact.
+     *
+     *  \param bits Number from the interval [1,52]
+     */
+    auto set_value_precision (int32 bits) -> void;
+
+    /**
+     *  \brief Default number of significant bits of terminal values
+     */
+    static constexpr int32 DefaultValuePrecision = 48;
+
+protected:
+    /**
+     *  \brief Initializes ADD manager.
+     *
+     *  This overload is for managers that have fixed domains.
+     *
+     *  \param varCount Number of variables.
+     *  \param nodePoolSize Size of the main node pool.
+     *  \param extraNodePoolSize Size of the additional node pools.
+     *  \param order Order of variables.
+     */
+    add_manager(
+        int32 varCount,
+        int64 nodePoolSize,
+        int64 extraNodePoolSize,
+        std::vector<int32> order
+    )
+    requires(domains::is_fixed<Domain>::value);
+
+    /**
+     *  \brief Initializes ADD manager.
+     *
+     *  This overload is for managers that have mixed domains.
+     *
+     *  \param varCount Number of variables.
+     *  \param nodePoolSize Size of the main node pool.
+     *  \param extraNodePoolSize Size of the additional node pools.
+     *  \param domain Domains of variables.
+     *  \param order Order of variables.
+     */
+    add_manager(
+        int32 varCount,
+        int64 nodePoolSize,
+        int64 extraNodePoolSize,
+        domains::mixed domain,
+        std::vector<int32> order
+    )
+    requires(domains::is_mixed<Domain>::value);
+
+public:
+    add_manager(add_manager&&) noexcept                     = default;
+    ~add_manager()                                          = default;
+    auto operator= (add_manager&&) noexcept -> add_manager& = default;
+    add_manager(add_manager const&)                         = delete;
+    auto operator= (add_manager const&) -> add_manager&     = delete;
+
+private:
+    using node_t        = typename diagram_t::node_t;
+    using son_container = typename node_t::son_container;
+
+private:
+    [[nodiscard]] auto make_value_node (double value) -> node_t*;
+    [[nodiscard]] auto get_node_value (node_t* node) const -> double;
+
+    /**
+     *  \brief Rounds \p value to \c precision_ significant bits
+     */
+    [[nodiscard]] auto round_value (double value) const -> double;
+
+    template<teddy_bin_op Op>
+    auto apply_impl (node_t* lhs, node_t* rhs) -> node_t*;
+
+    template<class Ps>
+    auto average_impl (
+        int32 opId,
+        Ps const& probs,
+        node_t* node,
+        int32 varIndex
+    ) -> node_t*;
+
+    static auto release (node_t* node) -> void;
+
+    static auto disown_sons (son_container const& sons, int32 domain) -> void;
+
+private:
+    /*
+     *  Ids of operations memoized in the computed table of the node manager.
+     *  Averaging depends on probabilities so it gets a fresh id for each call.
+     */
+    static constexpr int32 COFACTOR_OP_ID = 1;
+
+private:
+    // Terminal node with value i represents values_[i]. Values are
+    // looked up by their bits so that NaN can be found as well.
+    // Ids of values dropped by the GC are reused.
+    std::vector<double> values_;
+    std::unordered_map<uint64, int32> valueIds_;
+    std::vector<int32> freeIds_;
+    int32 precision_;
+    node_manager<void, Degree, domains::mixed> nodes_;
+};
+
+template<class Degree, class Domain>
+auto add_manager<Degree, Domain>::constant(double const value) -> diagram_t
+{
+    return diagram_t(this->make_value_node(value));
+}
+
+template<class Degree, class Domain>
+auto add_manager<Degree, Domain>::variable(int32 const index) -> diagram_t
+{
+    int32 const domain = nodes_.get_domain(index);
+    son_container sons = nodes_.make_son_container(domain);
+    for (int32 k = 0; k < domain; ++k)
+    {
+        sons[k] = this->make_value_node(static_cast<double>(k));
+    }
+    return diagram_t(nodes_.make_internal_node(index, sons));
+}
+
+template<class Degree, class Domain>
+template<class Data, class D, class Dm>
+auto add_manager<Degree, Domain>::from_diagram(
+    diagram_manager<Data, D, Dm> const& manager,
+    diagram<Data, D> const& diagram
+) -> diagram_t
+{
+    return this->from_diagram(
+        manager,
+        diagram,
+        [] (int32 const value) { return static_cast<double>(value); }
+    );
+}
+
+template<class Degree, class Domain>
+template<class Data, class D, class Dm, class F>
+auto add_manager<Degree, Domain>::from_diagram(
+    diagram_manager<Data, D, Dm> const& manager,
+    diagram<Data, D> const& diagram,
+    F transformer
+) -> diagram_t
+{
+    assert(manager.get_var_count() == this->get_var_count());
+    assert(manager.get_order() == this->get_order());
+    assert(manager.get_domains() == this->get_domains());
+
+    // Converted node of each source node is kept in the slot given
+    // by the id of the source node.
+    std::vector<node_t*> converted;
+    manager.nodes_.traverse_post_numbered(
+        diagram.unsafe_get_root(),
+        [this, &converted, &transformer] (node<Data, D>* const node)
+        {
+            if (node->is_terminal())
+            {
+                converted.push_back(this->make_value_node(
+                    static_cast<double>(transformer(node->get_value()))
+                ));
+                return;
+            }
+
+            int32 const index  = node->get_index();
+            int32 const domain = nodes_.get_domain(index);
+            son_container sons = nodes_.make_son_container(domain);
+            for (int32 k = 0; k < domain; ++k)
+            {
+                int64 const sonId = node->get_son(k)->get_scratch();
+                sons[k]           = converted[as_uindex(sonId)];
+            }
+            converted.push_back(nodes_.make_internal_node(index, sons));
+        }
+    );
+    return diagram_t(converted.back());
+}
+
+template<class Degree, class Domain>
+template<teddy_bin_op Op>
+auto add_manager<Degree, Domain>::apply(
+    diagram_t const& lhs,
+    diagram_t const& rhs
+) -> diagram_t
+{
+    return diagram_t(
+        this->apply_impl<Op>(lhs.unsafe_get_root(), rhs.unsafe_get_root())
+    );
+}
+
+template<class Degree, class Domain>
+auto add_manager<Degree, Domain>::get_cofactor(
+    diagram_t const& diagram,
+    int32 const varIndex,
+    int32 const varValue
+) -> diagram_t
+{
+    assert(nodes_.is_valid_var_value(varIndex, varValue));
+    int32 const varLevel = nodes_.get_level(varIndex);
+    auto const cofactor  = [this, varIndex, varValue, varLevel] (
+                              auto const& self,
+                              node_t* const node
+                          ) -> node_t*
+    {
+        if (node->is_terminal() || nodes_.get_level(node) > varLevel)
+        {
+            return node;
+        }
+
+        if (node->get_index() == varIndex)
+        {
+            return node->get_son(varValue);
+        }
+
+        node_t* const cached = nodes_.computed_find(
+            COFACTOR_OP_ID,
+            node,
+            nullptr,
+            varIndex,
+            varValue
+        );
+        if (cached)
+        {
+            return cached;
+        }
+
+        int32 const index  = node->get_index();
+        int32 const domain = nodes_.get_domain(index);
+        son_container sons = nodes_.make_son_container(domain);
+        for (int32 k = 0; k < domain; ++k)
+        {
+            sons[k] = self(self, node->get_son(k));
+        }
+        node_t* const result = nodes_.make_internal_node(index, sons);
+        nodes_.computed_put(
+            COFACTOR_OP_ID,
+            result,
+            node,
+            nullptr,
+            varIndex,
+            varValue
+        );
+        return result;
+    };
+    return diagram_t(cofactor(cofactor, diagram.unsafe_get_root()));
+}
+
+template<class Degree, class Domain>
+template<probs::prob_matrix Ps>
+auto add_manager<Degree, Domain>::average(
+    Ps const& probs,
+    diagram_t const& diagram,
+    int32 const varIndex
+) -> diagram_t
+{
+    int32 const opId = nodes_.make_operation_id();
+    diagram_t result(
+        this->average_impl(opId, probs, diagram.unsafe_get_root(), varIndex)
+    );
+    // Weights are terminal nodes that are used only as
+    // operands so they might have been left marked.
+    nodes_.for_each_terminal_node(id_set_notmarked<void, Degree>);
+    return result;
+}
+
+template<class Degree, class Domain>
+template<probs::prob_matrix Ps>
+auto add_manager<Degree, Domain>::expected_value(
+    Ps const& probs,
+    diagram_t const& diagram
+) const -> double
+{
+    std::vector<double> expected;
+    nodes_.traverse_post_numbered(
+        diagram.unsafe_get_root(),
+        [this, &probs, &expected] (node_t* const node)
+        {
+            if (node->is_terminal())
+            {
+                expected.push_back(this->get_node_value(node));
+            }
+            else
+            {
+                int32 const index  = node->get_index();
+                int32 const domain = nodes_.get_domain(index);
+                double value       = 0.0;
+                for (int32 k = 0; k < domain; ++k)
+                {
+                    int64 const sonId  = node->get_son(k)->get_scratch();
+                    value             += probs[as_uindex(index)][as_uindex(k)]
+                                       * expected[as_uindex(sonId)];
+                }
+                expected.push_back(value);
+            }
+        }
+    );
+    return expected.back();
+}
+
+template<class Degree, class Domain>
+template<probs::prob_vector Ps>
+auto add_manager<Degree, Domain>::expected_value(
+    Ps const& probs,
+    diagram_t const& diagram
+) const -> double
+{
+    return this->expected_value(
+        probs::details::prob_vector_wrap(probs),
+        diagram
+    );
+}
+
+template<class Degree, class Domain>
+template<in_var_values Vars>
+auto add_manager<Degree, Domain>::evaluate(
+    diagram_t const& diagram,
+    Vars const& values
+) const -> double
+{
+    node_t* node = diagram.unsafe_get_root();
+    while (not node->is_terminal())
+    {
+        int32 const index = node->get_index();
+        assert(nodes_.is_valid_var_value(index, values[as_uindex(index)]));
+        node = node->get_son(values[as_uindex(index)]);
+    }
+    return this->get_node_value(node);
+}
+
+template<class Degree, class Domain>
+auto add_manager<Degree, Domain>::get_node_count() const -> int64
+{
+    return nodes_.get_node_count();
+}
+
+template<class Degree, class Domain>
+auto add_manager<Degree, Domain>::get_node_count(diagram_t const& diagram
+) const -> int64
+{
+    return nodes_.get_node_count(diagram.unsafe_get_root());
+}
+
+template<class Degree, class Domain>
+auto add_manager<Degree, Domain>::force_gc() -> void
+{
+    nodes_.force_gc();
+    auto valIt = valueIds_.begin();
+    while (valIt != valueIds_.end())
+    {
+        if (nodes_.get_terminal_node(valIt->second))
+        {
+            ++valIt;
+        }
+        else
+        {
+            freeIds_.push_back(valIt->second);
+            valIt = valueIds_.erase(valIt);
+        }
+    }
+}
+
+template<class Degree, class Domain>
+auto add_manager<Degree, Domain>::clear_cache() -> void
+{
+    nodes_.cache_clear();
+}
+
+template<class Degree, class Domain>
+auto add_manager<Degree, Domain>::get_var_count() const -> int32
+{
+    return nodes_.get_var_count();
+}
+
+template<class Degree, class Domain>
+auto add_manager<Degree, Domain>::get_order() const
+    -> std::vector<int32> const&
+{
+    return nodes_.get_order();
+}
+
+template<class Degree, class Domain>
+auto add_manager<Degree, Domain>::get_domains() const -> std::vector<int32>
+{
+    return nodes_.get_domains();
+}
+
+template<class Degree, class Domain>
+auto add_manager<Degree, Domain>::set_cache_ratio(double const ratio) -> void
+{
+    nodes_.set_cache_ratio(ratio);
+}
+
+template<class Degree, class Domain>
+auto add_manager<Degree, Domain>::set_gc_ratio(double const ratio) -> void
+{
+    nodes_.set_gc_ratio(ratio);
+}
+
+template<class Degree, class Domain>
+auto add_manager<Degree, Domain>::set_value_precision(int32 const bits)
+    -> void
+{
+    assert(bits >= 1 && bits <= std::numeric_limits<double>::digits - 1);
+    precision_ = bits;
+}
+
+template<class Degree, class Domain>
+add_manager<Degree, Domain>::add_manager(
+    int32 const varCount,
+    int64 const nodePoolSize,
+    int64 const extraNodePoolSize,
+    std::vector<int32> order
+)
+requires(domains::is_fixed<Domain>::value)
+    :
+    values_(),
+    valueIds_(),
+    freeIds_(),
+    precision_(DefaultValuePrecision),
+    nodes_(
+        varCount,
+        nodePoolSize,
+        extraNodePoolSize,
+        detail::default_or_fwd(varCount, order),
+        std::vector<int32>(as_usize(varCount), Domain::value)
+    )
+{
+}
+
+template<class Degree, class Domain>
+add_manager<Degree, Domain>::add_manager(
+    int32 const varCount,
+    int64 const nodePoolSize,
+    int64 const extraNodePoolSize,
+    domains::mixed domain,
+    std::vector<int32> order
+)
+requires(domains::is_mixed<Domain>::value)
+    :
+    values_(),
+    valueIds_(),
+    freeIds_(),
+    precision_(DefaultValuePrecision),
+    nodes_(
+        varCount,
+        nodePoolSize,
+        extraNodePoolSize,
+        detail::default_or_fwd(varCount, order),
+        static_cast<domains::mixed&&>(domain)
+    )
+{
+}
+
+template<class Degree, class Domain>
+auto add_manager<Degree, Domain>::make_value_node(double value) -> node_t*
+{
+    // Negative zero would get a terminal different from zero
+    // and NaNs can have many different payloads.
+    if (value == 0.0)
+    {
+        value = 0.0;
+    }
+    else if (std::isnan(value))
+    {
+        value = std::numeric_limits<double>::quiet_NaN();
+    }
+
+    // The first value with the rounded key represents all of them.
+    auto const bits  = std::bit_cast<uint64>(this->round_value(value));
+    auto const valIt = valueIds_.find(bits);
+    if (valIt != valueIds_.end())
+    {
+        return nodes_.make_terminal_node(valIt->second);
+    }
+
+    int32 valueId = 0;
+    if (freeIds_.empty())
+    {
+        valueId = static_cast<int32>(ssize(values_));
+        values_.push_back(value);
+    }
+    else
+    {
+        valueId = freeIds_.back();
+        freeIds_.pop_back();
+        values_[as_uindex(valueId)] = value;
+    }
+    valueIds_.emplace(bits, valueId);
+    return nodes_.make_terminal_node(valueId);
+}
+
+template<class Degree, class Domain>
+auto add_manager<Degree, Domain>::round_value(double const value) const
+    -> double
+{
+    if (value == 0.0 || not std::isfinite(value))
+    {
+        return value;
+    }
+
+    // Rounds the mantissa half up, carry to the exponent is fine.
+    int32 const dropped
+        = std::numeric_limits<double>::digits - 1 - precision_;
+    if (dropped == 0)
+    {
+        return value;
+    }
+    uint64 const half    = uint64 {1} << (dropped - 1);
+    uint64 const mask    = ~((uint64 {1} << dropped) - 1);
+    auto const bits      = std::bit_cast<uint64>(value);
+    double const rounded = std::bit_cast<double>((bits + half) & mask);
+    return std::isinf(rounded) ? value : rounded;
+}
+
+template<class Degree, class Domain>
+auto add_manager<Degree, Domain>::get_node_value(node_t* const node) const
+    -> double
+{
+    return values_[as_uindex(node->get_value())];
+}
+
+template<class Degree, class Domain>
+template<teddy_bin_op Op>
+auto add_manager<Degree, Domain>::apply_impl(
+    node_t* const lhs,
+    node_t* const rhs
+) -> node_t*
+{
+    if (lhs->is_terminal() && rhs->is_terminal())
+    {
+        return this->make_value_node(
+            Op()(this->get_node_value(lhs), this->get_node_value(rhs))
+        );
+    }
+
+    if constexpr (utils::is_same<Op, real_ops::TIMES>::value)
+    {
+        if (lhs->is_terminal() && this->get_node_value(lhs) == 0.0)
+        {
+            return lhs;
+        }
+        if (rhs->is_terminal() && this->get_node_value(rhs) == 0.0)
+        {
+            return rhs;
+        }
+    }
+
+    node_t* const cached = nodes_.template cache_find<Op>(lhs, rhs);
+    if (cached)
+    {
+        return cached;
+    }
+
+    int32 const lhsLevel = nodes_.get_level(lhs);
+    int32 const rhsLevel = nodes_.get_level(rhs);
+    int32 const topLevel = utils::min(lhsLevel, rhsLevel);
+    int32 const topIndex = nodes_.get_index(topLevel);
+    int32 const domain   = nodes_.get_domain(topIndex);
+    son_container sons   = nodes_.make_son_container(domain);
+    for (int32 k = 0; k < domain; ++k)
+    {
+        sons[k] = this->apply_impl<Op>(
+            lhsLevel == topLevel ? lhs->get_son(k) : lhs,
+            rhsLevel == topLevel ? rhs->get_son(k) : rhs
+        );
+    }
+
+    node_t* const result = nodes_.make_internal_node(topIndex, sons);
+    nodes_.template cache_put<Op>(result, lhs, rhs);
+    return result;
+}
+
+template<class Degree, class Domain>
+template<class Ps>
+auto add_manager<Degree, Domain>::average_impl(
+    int32 const opId,
+    Ps const& probs,
+    node_t* const node,
+    int32 const varIndex
+) -> node_t*
+{
+    // Probabilities sum up to one so the average of a function
+    // that does not depend on the variable is the function itself.
+    if (node->is_terminal()
+        || nodes_.get_level(node) > nodes_.get_level(varIndex))
+    {
+        return node;
+    }
+
+    node_t* const cached
+        = nodes_.computed_find(opId, node, nullptr, varIndex, 0);
+    if (cached)
+    {
+        return cached;
+    }
+
+    int32 const index  = node->get_index();
+    int32 const domain = nodes_.get_domain(index);
+    node_t* result     = nullptr;
+    if (index == varIndex)
+    {
+        // Weighted sum of the sons. Intermediate results are referenced
+        // so that releasing them can't expose other results to the GC.
+        node_t* sum = id_inc_ref_count(this->make_value_node(0.0));
+        for (int32 k = 0; k < domain; ++k)
+        {
+            double const prob  = probs[as_uindex(index)][as_uindex(k)];
+            node_t* const term = id_inc_ref_count(
+                this->apply_impl<real_ops::TIMES>(
+                    this->make_value_node(prob),
+                    node->get_son(k)
+                )
+            );
+            node_t* const next = id_inc_ref_count(
+                this->apply_impl<real_ops::PLUS>(sum, term)
+            );
+            release(term);
+            release(sum);
+            sum = next;
+        }
+        sum->dec_ref_count();
+        result = id_set_marked(sum);
+    }
+    else
+    {
+        son_container sons = nodes_.make_son_container(domain);
+        for (int32 k = 0; k < domain; ++k)
+        {
+            sons[k] = id_inc_ref_count(
+                this->average_impl(opId, probs, node->get_son(k), varIndex)
+            );
+        }
+        disown_sons(sons, domain);
+        result = nodes_.make_internal_node(index, sons);
+    }
+
+    nodes_.computed_put(opId, result, node, nullptr, varIndex, 0);
+    return result;
+}
+
+template<class Degree, class Domain>
+auto add_manager<Degree, Domain>::release(node_t* const node) -> void
+{
+    // Intermediate result that is not used as a son of any node
+    // must not stay marked, otherwise it would never be collected.
+    node->dec_ref_count();
+    node->set_notmarked();
+}
+
+template<class Degree, class Domain>
+auto add_manager<Degree, Domain>::disown_sons(
+    son_container const& sons,
+    int32 const domain
+) -> void
+{
+    for (int32 k = 0; k < domain; ++k)
+    {
+        sons[k]->dec_ref_count();
+        sons[k]->set_marked();
+    }
+}
+} // namespace teddy
+
+#endif
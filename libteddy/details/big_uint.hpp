@@ -0,0 +1,190 @@
+#ifndef LIBTEDDY_DETAILS_BIG_UINT_HPP
+#define LIBTEDDY_DETAILS_BIG_UINT_HPP
+
+#include <libteddy/details/types.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+
+namespace teddy
+{
+/**
+ *  \brief Unsigned integer with a fixed number of 32-bit words
+ *
+ *  Can be used as a count type for \c satisfy_count when the number of
+ *  satisfying assignments does not fit into 64 bits. Like built-in unsigned
+ *  types, arithmetic is modulo 2 ^ (32 * WordCount).
+ *
+ *  \tparam WordCount Number of 32-bit words
+ */
+template<int32 WordCount>
+class big_uint
+{
+public:
+    static_assert(WordCount > 0);
+
+public:
+    big_uint();
+    big_uint(int64 value);
+
+    auto operator+= (big_uint const& other) -> big_uint&;
+    auto operator*= (big_uint const& other) -> big_uint&;
+
+    /**
+     *  \return Approximate value as double
+     */
+    explicit operator double () const;
+
+    /**
+     *  \return Decimal representation of the value
+     */
+    [[nodiscard]] auto to_string () const -> std::string;
+
+    friend auto operator+ (big_uint lhs, big_uint const& rhs) -> big_uint
+    {
+        return lhs += rhs;
+    }
+
+    friend auto operator* (big_uint lhs, big_uint const& rhs) -> big_uint
+    {
+        return lhs *= rhs;
+    }
+
+    friend auto operator== (big_uint const& lhs, big_uint const& rhs) -> bool
+    {
+        return std::equal(lhs.words_, lhs.words_ + WordCount, rhs.words_);
+    }
+
+private:
+    /**
+     *  \brief Divides the value by \p divisor in place
+     *  \return Remainder
+     */
+    auto divide (uint32 divisor) -> uint32;
+
+    [[nodiscard]] auto is_zero () const -> bool;
+
+private:
+    // Least significant word first.
+    uint32 words_[as_usize(WordCount)];
+};
+
+template<int32 WordCount>
+big_uint<WordCount>::big_uint() :
+    words_ {}
+{
+}
+
+template<int32 WordCount>
+big_uint<WordCount>::big_uint(int64 const value) :
+    words_ {}
+{
+    assert(value >= 0);
+    auto const bits = static_cast<uint64>(value);
+    words_[0]       = static_cast<uint32>(bits);
+    if constexpr (WordCount > 1)
+    {
+        words_[1] = static_cast<uint32>(bits >> 32);
+    }
+}
+
+template<int32 WordCount>
+auto big_uint<WordCount>::operator+= (big_uint const& other) -> big_uint&
+{
+    uint64 carry = 0;
+    for (int32 i = 0; i < WordCount; ++i)
+    {
+        uint64 const sum = uint64 {words_[i]} + other.words_[i] + carry;
+        words_[i]        = static_cast<uint32>(sum);
+        carry            = sum >> 32;
+    }
+    return *this;
+}
+
+template<int32 WordCount>
+auto big_uint<WordCount>::operator*= (big_uint const& other) -> big_uint&
+{
+    uint32 product[as_usize(WordCount)] {};
+    for (int32 i = 0; i < WordCount; ++i)
+    {
+        uint64 carry = 0;
+        for (int32 j = 0; i + j < WordCount; ++j)
+        {
+            uint64 const part = uint64 {words_[i]} * other.words_[j]
+                              + product[i + j] + carry;
+            product[i + j] = static_cast<uint32>(part);
+            carry          = part >> 32;
+        }
+    }
+    std::copy(product, product + WordCount, words_);
+    return *this;
+}
+
+template<int32 WordCount>
+big_uint<WordCount>::operator double () const
+{
+    double result = 0.0;
+    for (int32 i = WordCount - 1; i >= 0; --i)
+    {
+        result = result * 4'294'967'296.0 + static_cast<double>(words_[i]);
+    }
+    return result;
+}
+
+template<int32 WordCount>
+auto big_uint<WordCount>::to_string() const -> std::string
+{
+    if (this->is_zero())
+    {
+        return "0";
+    }
+
+    // Divides by 10^9 and prints the remainders as 9-digit blocks.
+    uint32 constexpr BlockBase  = 1'000'000'000;
+    int32 constexpr BlockDigits = 9;
+    big_uint rest               = *this;
+    std::string digits;
+    while (not rest.is_zero())
+    {
+        uint32 block = rest.divide(BlockBase);
+        for (int32 i = 0; i < BlockDigits; ++i)
+        {
+            digits.push_back(static_cast<char>('0' + block % 10));
+            block /= 10;
+        }
+    }
+
+    while (digits.size() > 1 && digits.back() == '0')
+    {
+        digits.pop_back();
+    }
+    std::reverse(digits.begin(), digits.end());
+    return digits;
+}
+
+template<int32 WordCount>
+auto big_uint<WordCount>::divide(uint32 const divisor) -> uint32
+{
+    uint64 remainder = 0;
+    for (int32 i = WordCount - 1; i >= 0; --i)
+    {
+        uint64 const current = (remainder << 32) | words_[i];
+        words_[i]            = static_cast<uint32>(current / divisor);
+        remainder            = current % divisor;
+    }
+    return static_cast<uint32>(remainder);
+}
+
+template<int32 WordCount>
+auto big_uint<WordCount>::is_zero() const -> bool
+{
+    return std::all_of(
+        words_,
+        words_ + WordCount,
+        [] (uint32 const word) { return word == 0; }
+    );
+}
+} // namespace teddy
+
+#endif
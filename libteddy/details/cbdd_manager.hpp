@@ -0,0 +1,763 @@
+#ifndef LIBTEDDY_DETAILS_CBDD_MANAGER_HPP
+#define LIBTEDDY_DETAILS_CBDD_MANAGER_HPP
+
+#include <libteddy/details/diagram.hpp>
+#include <libteddy/details/diagram_manager.hpp>
+#include <libteddy/details/node_manager.hpp>
+#include <libteddy/details/operators.hpp>
+#include <libteddy/details/probabilities.hpp>
+#include <libteddy/details/tools.hpp>
+#include <libteddy/details/types.hpp>
+
+#include <cassert>
+#include <cmath>
+#include <iterator>
+#include <ostream>
+#include <ranges>
+#include <vector>
+
+namespace teddy
+{
+/**
+ *  \class cbdd_manager
+ *  \brief Diagram manager for Binary Decision Diagrams with complement edges
+ *
+ *  Edges of the diagram can be complemented. Complement tag is stored
+ *  in the lowest bit of a son pointer. Function and its negation share
+ *  all of the nodes so negation is a constant time operation. The only
+ *  terminal node is 1, constant 0 is a complemented edge to 1.
+ *  Canonical form is ensured by keeping the 1-son of each node regular.
+ *
+ *  Diagrams created by this manager must not be used with other managers.
+ */
+class cbdd_manager
+{
+public:
+    /**
+     *  \brief Alias for the diagram type used in the
+     *  functions of this manager.
+     */
+    using diagram_t = diagram<void, degrees::fixed<2>>;
+
+public:
+    /**
+     *  \brief Initializes complement edge BDD manager.
+     *
+     *  \param varCount Number of variables.
+     *  \param nodePoolSize Size of the main node pool.
+     *  \param order Order of variables. Variables are ordered
+     *  by their indices by default.
+     */
+    cbdd_manager(
+        int32 varCount,
+        int64 nodePoolSize,
+        std::vector<int32> order = std::vector<int32>()
+    );
+
+    /**
+     *  \brief Initializes complement edge BDD manager.
+     *
+     *  \param varCount Number of variables.
+     *  \param nodePoolSize Size of the main node pool.
+     *  \param overflowNodePoolSize Size of the additional node pools.
+     *  \param order Order of variables. Variables are ordered
+     *  by their indices by default.
+     */
+    cbdd_manager(
+        int32 varCount,
+        int64 nodePoolSize,
+        int64 overflowNodePoolSize,
+        std::vector<int32> order = std::vector<int32>()
+    );
+
+    /**
+     *  \brief Creates diagram representing constant function
+     *  \param val Value of the constant function, 0 or 1
+     *  \return Diagram representing constant function
+     */
+    auto constant (int32 val) -> diagram_t;
+
+    /**
+     *  \brief Creates diagram representing function of single variable
+     *  \param index Index of the variable
+     *  \return Diagram of a function of single variable
+     */
+    auto variable (int32 index) -> diagram_t;
+
+    /**
+     *  \brief Creates diagram representing complemented variable
+     *  \param index Index of the variable
+     *  \return Diagram of a function of single variable
+     */
+    auto variable_not (int32 index) -> diagram_t;
+
+    /**
+     *  \brief Creates diagram representing function of single variable
+     *  \param index Index of the variable
+     *  \return Diagram of a function of single variable
+     */
+    auto operator() (int32 index) -> diagram_t;
+
+    /**
+     *  \brief Creates vector of diagrams representing single variables
+     *  \tparam Is range of integral indices
+     *  \param indices range of Ts (e.g. std::vector<int>)
+     *  \return Vector of diagrams
+     */
+    template<std::ranges::input_range Is>
+    auto variables (Is const& indices) -> std::vector<diagram_t>;
+
+    /**
+     *  \brief Merges two diagrams using given binary operation.
+     *
+     *  Supports the Boolean operations and relations from \c teddy::ops
+     *  i.e., AND, OR, XOR, NAND, NOR, XNOR, IMPLIES, EQUAL_TO,
+     *  NOT_EQUAL_TO, LESS, LESS_EQUAL, GREATER, GREATER_EQUAL, MIN, MAX.
+     *  All of them are reduced to AND or XOR using complement edges
+     *  so that they share entries in the apply cache.
+     *
+     *  \tparam Op Binary operation
+     *  \param lhs first diagram
+     *  \param rhs second diagram
+     *  \return Diagram representing merger of \p lhs and \p rhs
+     */
+    template<teddy_bin_op Op>
+    auto apply (diagram_t const& lhs, diagram_t const& rhs) -> diagram_t;
+
+    /**
+     *  \brief Merges diagams in the range using the \c apply function
+     *  and binary operation
+     *
+     *  Uses left fold order of evaluation (sequentially from the left).
+     *
+     *  \tparam Op Binary operation
+     *  \tparam R Range containing diagrams (e.g. std::vector<diagram_t>)
+     *  \param diagrams Input range of diagrams to be merged
+     *  \return Diagram representing merger of all diagrams from the range
+     */
+    template<teddy_bin_op Op, std::ranges::input_range R>
+    auto left_fold (R const& diagrams) -> diagram_t;
+
+    /**
+     *  \brief Merges diagams in the range using the \c apply function
+     *  and binary operation
+     *
+     *  Uses tree fold order of evaluation ((d1 op d2) op (d3 op d4) ...) .
+     *  Tree fold uses the input range \p range to store some intermediate
+     *  results. \p range is left in valid but unspecified state.
+     *
+     *  \tparam Op Binary operation
+     *  \tparam R Range containing diagrams (e.g. std::vector<diagram_t>)
+     *  \param diagrams Random access range of diagrams to be merged
+     *  \return Diagram representing merger of all diagrams from the range
+     */
+    template<teddy_bin_op Op, std::ranges::random_access_range R>
+    auto tree_fold (R& diagrams) -> diagram_t;
+
+    /**
+     *  \brief Negates Boolean function
+     *
+     *  Complexity is \c O(1) .
+     *
+     *  \param diagram Diagram representing the function
+     *  \return Diagram representing negation of the function
+     */
+    auto negate (diagram_t const& diagram) -> diagram_t;
+
+    /**
+     *  \brief Evaluates value of the function represented by the diagram
+     *
+     *  Complexity is \c O(n) where \c n is the number of variables.
+     *
+     *  \tparam Vars Container type that defines operator[] and returns
+     *  value convertible to int
+     *  \param diagram Diagram
+     *  \param values Container holding values of variables
+     *  \return Value of the function for variable values given in \p values
+     */
+    template<in_var_values Vars>
+    auto evaluate (diagram_t const& diagram, Vars const& values) const -> int32;
+
+    /**
+     *  \brief Calculates number of variable assignments for which
+     *  the functions evaluates to certain value
+     *
+     *  Complexity is \c O(|d|) where \c |d| is the number of nodes.
+     *
+     *  \param value Value of the function
+     *  \param diagram Diagram representing the function
+     *  \return Number of different variable assignments for which the
+     *  the function evaluates to \p value
+     */
+    auto satisfy_count (int32 value, diagram_t const& diagram) -> int64;
+
+    /**
+     *  \brief Calculates probability that the function evaluates to 1
+     *
+     *  \p probs[i] must return probability that i-th variable is 1.
+     *  Complexity is \c O(|d|) where \c |d| is the number of nodes.
+     *
+     *  \tparam Ps Type that holds probabilities of variables
+     *  \param probs vector of probabilities
+     *  \param diagram Diagram representing the function
+     *  \return Probability that the function evaluates to 1
+     */
+    template<probs::prob_vector Ps>
+    auto calculate_probability (Ps const& probs, diagram_t const& diagram)
+        -> double;
+
+    /**
+     *  \brief Returns number of nodes that are currently
+     *  used by the manager.
+     *  \return Number of nodes
+     */
+    [[nodiscard]] auto get_node_count () const -> int64;
+
+    /**
+     *  \brief Returns number of nodes in the diagram including
+     *  the terminal node
+     *  \param diagram Diagram
+     *  \return Number of node
+     */
+    auto get_node_count (diagram_t const& diagram) const -> int64;
+
+    /**
+     *  \brief Prints dot representation of the graph
+     *
+     *  Complemented edges are drawn as dotted lines.
+     *
+     *  \param out Output stream (e.g. \c std::cout or \c std::ofstream )
+     */
+    auto to_dot_graph (std::ostream& out) const -> void;
+
+    /**
+     *  \brief Prints dot representation of the diagram
+     *
+     *  Complemented edges are drawn as dotted lines.
+     *
+     *  \param out Output stream (e.g. \c std::cout or \c std::ofstream )
+     *  \param diagram Diagram
+     */
+    auto to_dot_graph (std::ostream& out, diagram_t const& diagram) const
+        -> void;
+
+    /**
+     *  \brief Runs garbage collection.
+     */
+    auto force_gc () -> void;
+
+    /**
+     *  \brief Clears apply cache.
+     */
+    auto clear_cache () -> void;
+
+    /**
+     *  \brief Returns number of variables for this manager
+     *  set in the constructor.
+     *  \return Number of variables.
+     */
+    [[nodiscard]] auto get_var_count () const -> int32;
+
+    /**
+     *  \brief Returns order of variables.
+     *  \return Vector of indices. Index at l-th position is the
+     *  index of variable at l-th level of the diagram.
+     */
+    [[nodiscard]] auto get_order () const -> std::vector<int32> const&;
+
+    /**
+     *  \brief Sets the relative cache size w.r.t the number of nodes
+     *  \param ratio Number from the interval (0,oo)
+     */
+    auto set_cache_ratio (double ratio) -> void;
+
+    /**
+     *  \brief Sets ratio used to determine new node pool allocation
+     *  \param ratio Number from the interval [0,1]
+     */
+    auto set_gc_ratio (double ratio) -> void;
+
+private:
+    using node_t        = diagram_t::node_t;
+    using son_container = node_t::son_container;
+
+private:
+    [[nodiscard]] auto make_one () -> node_t*;
+    [[nodiscard]] auto make_zero () -> node_t*;
+    [[nodiscard]] static auto is_constant (node_t* edge) -> bool;
+    [[nodiscard]] static auto get_son (node_t* edge, int32 sonOrder)
+        -> node_t*;
+
+    auto and_impl (node_t* lhs, node_t* rhs) -> node_t*;
+    auto xor_impl (node_t* lhs, node_t* rhs) -> node_t*;
+
+private:
+    node_manager<void, degrees::fixed<2>, domains::fixed<2>> nodes_;
+};
+
+inline cbdd_manager::cbdd_manager(
+    int32 const varCount,
+    int64 const nodePoolSize,
+    std::vector<int32> order
+) :
+    cbdd_manager(
+        varCount,
+        nodePoolSize,
+        nodePoolSize / 2,
+        static_cast<std::vector<int32>&&>(order)
+    )
+{
+}
+
+inline cbdd_manager::cbdd_manager(
+    int32 const varCount,
+    int64 const nodePoolSize,
+    int64 const overflowNodePoolSize,
+    std::vector<int32> order
+) :
+    nodes_(
+        varCount,
+        nodePoolSize,
+        overflowNodePoolSize,
+        detail::default_or_fwd(varCount, order)
+    )
+{
+}
+
+inline auto cbdd_manager::constant(int32 const val) -> diagram_t
+{
+    assert(val == 0 || val == 1);
+    return diagram_t(val == 1 ? this->make_one() : this->make_zero());
+}
+
+inline auto cbdd_manager::variable(int32 const index) -> diagram_t
+{
+    son_container sons = nodes_.make_son_container(2);
+    sons[0]            = this->make_zero();
+    sons[1]            = this->make_one();
+    return diagram_t(nodes_.make_internal_node(index, sons));
+}
+
+inline auto cbdd_manager::variable_not(int32 const index) -> diagram_t
+{
+    return this->negate(this->variable(index));
+}
+
+inline auto cbdd_manager::operator() (int32 const index) -> diagram_t
+{
+    return this->variable(index);
+}
+
+template<std::ranges::input_range Is>
+auto cbdd_manager::variables(Is const& indices) -> std::vector<diagram_t>
+{
+    std::vector<diagram_t> result;
+    for (auto const index : indices)
+    {
+        result.push_back(this->variable(static_cast<int32>(index)));
+    }
+    return result;
+}
+
+template<teddy_bin_op Op>
+auto cbdd_manager::apply(diagram_t const& lhs, diagram_t const& rhs)
+    -> diagram_t
+{
+    node_t* const l = lhs.unsafe_get_root();
+    node_t* const r = rhs.unsafe_get_root();
+    node_t* result  = nullptr;
+
+    if constexpr (utils::is_same<Op, ops::AND>::value
+                  || utils::is_same<Op, ops::MIN>::value)
+    {
+        result = this->and_impl(l, r);
+    }
+    else if constexpr (utils::is_same<Op, ops::OR>::value
+                       || utils::is_same<Op, ops::MAX>::value)
+    {
+        // De Morgan: l or r = not (not l and not r)
+        result = complement_edge(
+            this->and_impl(complement_edge(l), complement_edge(r))
+        );
+    }
+    else if constexpr (utils::is_same<Op, ops::XOR>::value
+                       || utils::is_same<Op, ops::NOT_EQUAL_TO>::value)
+    {
+        result = this->xor_impl(l, r);
+    }
+    else if constexpr (utils::is_same<Op, ops::NAND>::value)
+    {
+        result = complement_edge(this->and_impl(l, r));
+    }
+    else if constexpr (utils::is_same<Op, ops::NOR>::value)
+    {
+        result = this->and_impl(complement_edge(l), complement_edge(r));
+    }
+    else if constexpr (utils::is_same<Op, ops::XNOR>::value
+                       || utils::is_same<Op, ops::EQUAL_TO>::value)
+    {
+        result = complement_edge(this->xor_impl(l, r));
+    }
+    else if constexpr (utils::is_same<Op, ops::IMPLIES>::value
+                       || utils::is_same<Op, ops::LESS_EQUAL>::value)
+    {
+        result = complement_edge(this->and_impl(l, complement_edge(r)));
+    }
+    else if constexpr (utils::is_same<Op, ops::LESS>::value)
+    {
+        result = this->and_impl(complement_edge(l), r);
+    }
+    else if constexpr (utils::is_same<Op, ops::GREATER>::value)
+    {
+        result = this->and_impl(l, complement_edge(r));
+    }
+    else if constexpr (utils::is_same<Op, ops::GREATER_EQUAL>::value)
+    {
+        result = complement_edge(this->and_impl(complement_edge(l), r));
+    }
+    else
+    {
+        static_assert(
+            utils::is_same<Op, void>::value,
+            "Operation is not supported by cbdd_manager."
+        );
+    }
+
+    return diagram_t(result);
+}
+
+template<teddy_bin_op Op, std::ranges::input_range R>
+auto cbdd_manager::left_fold(R const& diagrams) -> diagram_t
+{
+    auto first      = begin(diagrams);
+    auto const last = end(diagrams);
+
+    diagram_t result = *first;
+    ++first;
+
+    while (first != last)
+    {
+        result = this->apply<Op>(result, *first);
+        ++first;
+    }
+
+    return result;
+}
+
+template<teddy_bin_op Op, std::ranges::random_access_range R>
+auto cbdd_manager::tree_fold(R& diagrams) -> diagram_t
+{
+    auto const first      = begin(diagrams);
+    int64 const count     = ssize(diagrams);
+    int64 currentCount    = count;
+    auto const numOfSteps = static_cast<int64>(std::ceil(std::log2(count)));
+
+    for (auto step = 0; step < numOfSteps; ++step)
+    {
+        auto const justMoveLast = static_cast<bool>(currentCount & 1);
+        currentCount            = (currentCount / 2) + justMoveLast;
+        int64 const pairCount   = currentCount - justMoveLast;
+
+        for (int64 i = 0; i < pairCount; ++i)
+        {
+            *(first + i)
+                = this->apply<Op>(*(first + 2 * i), *(first + 2 * i + 1));
+        }
+
+        if (justMoveLast)
+        {
+            *(first + currentCount - 1)
+                = static_cast<diagram_t&&>(*(first + 2 * (currentCount - 1)));
+        }
+    }
+
+    return diagram_t(static_cast<diagram_t&&>(*first));
+}
+
+inline auto cbdd_manager::negate(diagram_t const& diagram) -> diagram_t
+{
+    return diagram_t(complement_edge(diagram.unsafe_get_root()));
+}
+
+template<in_var_values Vars>
+auto cbdd_manager::evaluate(diagram_t const& diagram, Vars const& values) const
+    -> int32
+{
+    node_t* edge     = diagram.unsafe_get_root();
+    bool complemented = false;
+
+    while (not regular_edge(edge)->is_terminal())
+    {
+        complemented ^= is_complemented(edge);
+        node_t* const node = regular_edge(edge);
+        int32 const index  = node->get_index();
+        assert(nodes_.is_valid_var_value(index, values[as_uindex(index)]));
+        edge = node->get_son(values[as_uindex(index)]);
+    }
+
+    complemented ^= is_complemented(edge);
+    return complemented ? 0 : 1;
+}
+
+inline auto cbdd_manager::satisfy_count(
+    int32 const value,
+    diagram_t const& diagram
+) -> int64
+{
+    assert(value == 0 || value == 1);
+
+    // Number of ones of a function given by the edge, counted over
+    // variables from the level of the node to the leaf level.
+    std::vector<int64>& ones = nodes_.get_scratch_buffer();
+    int32 const leafLevel    = nodes_.get_leaf_level();
+    auto const edge_count    = [this, &ones, leafLevel] (node_t* const edge)
+    {
+        node_t* const node = regular_edge(edge);
+        int64 const count  = ones[as_uindex(node->get_scratch())];
+        return is_complemented(edge)
+                 ? nodes_.domain_product(nodes_.get_level(node), leafLevel)
+                       - count
+                 : count;
+    };
+
+    node_t* const root = diagram.unsafe_get_root();
+    nodes_.traverse_post_numbered(
+        root,
+        [this, &ones, &edge_count] (node_t* const node)
+        {
+            if (node->is_terminal())
+            {
+                ones.push_back(1);
+            }
+            else
+            {
+                int32 const nodeLevel = nodes_.get_level(node);
+                int64 count           = 0;
+                for (int32 k = 0; k < 2; ++k)
+                {
+                    node_t* const son    = node->get_son(k);
+                    int32 const sonLevel = nodes_.get_level(regular_edge(son));
+                    count += edge_count(son)
+                           * nodes_.domain_product(nodeLevel + 1, sonLevel);
+                }
+                ones.push_back(count);
+            }
+        }
+    );
+
+    int32 const rootLevel = nodes_.get_level(regular_edge(root));
+    int64 const rootOnes
+        = edge_count(root) * nodes_.domain_product(0, rootLevel);
+    return value == 1 ? rootOnes
+                      : nodes_.domain_product(0, leafLevel) - rootOnes;
+}
+
+template<probs::prob_vector Ps>
+auto cbdd_manager::calculate_probability(
+    Ps const& probs,
+    diagram_t const& diagram
+) -> double
+{
+    // Probability of a one of each node in the slot given by its id.
+    std::vector<double> ones;
+    auto const edge_prob = [&ones] (node_t* const edge)
+    {
+        int32 const id    = regular_edge(edge)->get_scratch();
+        double const prob = ones[as_uindex(id)];
+        return is_complemented(edge) ? 1.0 - prob : prob;
+    };
+
+    node_t* const root = diagram.unsafe_get_root();
+    nodes_.traverse_post_numbered(
+        root,
+        [&ones, &probs, &edge_prob] (node_t* const node)
+        {
+            if (node->is_terminal())
+            {
+                ones.push_back(1.0);
+            }
+            else
+            {
+                double const p = probs[as_uindex(node->get_index())];
+                ones.push_back(
+                    (1.0 - p) * edge_prob(node->get_son(0))
+                    + p * edge_prob(node->get_son(1))
+                );
+            }
+        }
+    );
+
+    return edge_prob(root);
+}
+
+inline auto cbdd_manager::get_node_count() const -> int64
+{
+    return nodes_.get_node_count();
+}
+
+inline auto cbdd_manager::get_node_count(diagram_t const& diagram) const
+    -> int64
+{
+    return nodes_.get_node_count(diagram.unsafe_get_root());
+}
+
+inline auto cbdd_manager::to_dot_graph(std::ostream& out) const -> void
+{
+    nodes_.to_dot_graph(out);
+}
+
+inline auto cbdd_manager::to_dot_graph(
+    std::ostream& out,
+    diagram_t const& diagram
+) const -> void
+{
+    nodes_.to_dot_graph(out, regular_edge(diagram.unsafe_get_root()));
+}
+
+inline auto cbdd_manager::force_gc() -> void
+{
+    nodes_.force_gc();
+}
+
+inline auto cbdd_manager::clear_cache() -> void
+{
+    nodes_.cache_clear();
+}
+
+inline auto cbdd_manager::get_var_count() const -> int32
+{
+    return nodes_.get_var_count();
+}
+
+inline auto cbdd_manager::get_order() const -> std::vector<int32> const&
+{
+    return nodes_.get_order();
+}
+
+inline auto cbdd_manager::set_cache_ratio(double const ratio) -> void
+{
+    nodes_.set_cache_ratio(ratio);
+}
+
+inline auto cbdd_manager::set_gc_ratio(double const ratio) -> void
+{
+    nodes_.set_gc_ratio(ratio);
+}
+
+inline auto cbdd_manager::make_one() -> node_t*
+{
+    return nodes_.make_terminal_node(1);
+}
+
+inline auto cbdd_manager::make_zero() -> node_t*
+{
+    return complement_edge(nodes_.make_terminal_node(1));
+}
+
+inline auto cbdd_manager::is_constant(node_t* const edge) -> bool
+{
+    return regular_edge(edge)->is_terminal();
+}
+
+inline auto cbdd_manager::get_son(node_t* const edge, int32 const sonOrder)
+    -> node_t*
+{
+    node_t* const son = regular_edge(edge)->get_son(sonOrder);
+    return is_complemented(edge) ? complement_edge(son) : son;
+}
+
+inline auto cbdd_manager::and_impl(node_t* const lhs, node_t* const rhs)
+    -> node_t*
+{
+    if (lhs == rhs)
+    {
+        return lhs;
+    }
+
+    if (lhs == complement_edge(rhs))
+    {
+        return this->make_zero();
+    }
+
+    if (is_constant(lhs))
+    {
+        return is_complemented(lhs) ? lhs : rhs;
+    }
+
+    if (is_constant(rhs))
+    {
+        return is_complemented(rhs) ? rhs : lhs;
+    }
+
+    node_t* const cached = nodes_.cache_find<ops::AND>(lhs, rhs);
+    if (cached)
+    {
+        return cached;
+    }
+
+    int32 const lhsLevel = nodes_.get_level(regular_edge(lhs));
+    int32 const rhsLevel = nodes_.get_level(regular_edge(rhs));
+    int32 const topLevel = utils::min(lhsLevel, rhsLevel);
+    int32 const topIndex = nodes_.get_index(topLevel);
+    son_container sons   = nodes_.make_son_container(2);
+    for (int32 k = 0; k < 2; ++k)
+    {
+        sons[k] = this->and_impl(
+            lhsLevel == topLevel ? get_son(lhs, k) : lhs,
+            rhsLevel == topLevel ? get_son(rhs, k) : rhs
+        );
+    }
+
+    node_t* const result = nodes_.make_internal_node(topIndex, sons);
+    nodes_.cache_put<ops::AND>(result, lhs, rhs);
+    return result;
+}
+
+inline auto cbdd_manager::xor_impl(node_t* lhs, node_t* rhs) -> node_t*
+{
+    // Complements of operands are moved to the result so that
+    // all four combinations share the same cache entry.
+    bool const flip = is_complemented(lhs) != is_complemented(rhs);
+    lhs             = regular_edge(lhs);
+    rhs             = regular_edge(rhs);
+
+    node_t* result = nullptr;
+    if (lhs == rhs)
+    {
+        result = this->make_zero();
+    }
+    else if (is_constant(lhs))
+    {
+        result = complement_edge(rhs);
+    }
+    else if (is_constant(rhs))
+    {
+        result = complement_edge(lhs);
+    }
+    else
+    {
+        result = nodes_.cache_find<ops::XOR>(lhs, rhs);
+        if (not result)
+        {
+            int32 const lhsLevel = nodes_.get_level(lhs);
+            int32 const rhsLevel = nodes_.get_level(rhs);
+            int32 const topLevel = utils::min(lhsLevel, rhsLevel);
+            int32 const topIndex = nodes_.get_index(topLevel);
+            son_container sons   = nodes_.make_son_container(2);
+            for (int32 k = 0; k < 2; ++k)
+            {
+                sons[k] = this->xor_impl(
+                    lhsLevel == topLevel ? lhs->get_son(k) : lhs,
+                    rhsLevel == topLevel ? rhs->get_son(k) : rhs
+                );
+            }
+            result = nodes_.make_internal_node(topIndex, sons);
+            nodes_.cache_put<ops::XOR>(result, lhs, rhs);
+        }
+    }
+
+    return flip ? complement_edge(result) : result;
+}
+} // namespace teddy
+
+#endif
@@ -21,6 +21,17 @@
  */
 // #define LIBTEDDY_COLLECT_STATS
 
+/**
+ *  Enables memory-mapping of PLA files and diagram images
+ *  on POSIX platforms. Otherwise, PLA files are streamed through
+ *  a fixed-size buffer and diagram images are read into memory.
+ *  It is opt-in since POSIX headers declare many names
+ *  in the global namespace.
+ *
+ *  This option can also be enabled in the root CMakeLists.txt
+ */
+// #define LIBTEDDY_MAPPED_FILES
+
 /**
  *  Enables symbolic probabilistic evaluation
  *  See the documentation for dependencies
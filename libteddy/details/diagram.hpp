@@ -151,7 +151,7 @@ diagram<Data, Degree>::~diagram()
 {
     if (root_)
     {
-        root_->dec_ref_count();
+        regular_edge(root_)->dec_ref_count();
     }
 }
 
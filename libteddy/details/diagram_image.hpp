@@ -0,0 +1,572 @@
+#ifndef LIBTEDDY_DETAILS_DIAGRAM_IMAGE_HPP
+#define LIBTEDDY_DETAILS_DIAGRAM_IMAGE_HPP
+
+#include <libteddy/details/mapped_file.hpp>
+#include <libteddy/details/types.hpp>
+
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace teddy
+{
+/**
+ *  \brief Immutable read-only copy of a diagram stored in flat arrays
+ *
+ *  Nodes are stored in a single array ordered by levels so that the root
+ *  is the first node and sons always follow their parents. Sons are
+ *  referenced by 32-bit offsets into the same array. The image does not
+ *  depend on the manager that created it, it has no reference counts and
+ *  all its methods are const so that it can be shared between threads.
+ *
+ *  Images can be saved to a file and opened again. If
+ *  \c LIBTEDDY_MAPPED_FILES is defined, the file is memory-mapped and
+ *  the arrays are not copied so processes that open the same file share
+ *  a single copy of it through the page cache. Otherwise, the file is
+ *  read into memory. Copies of an image share the arrays.
+ */
+class diagram_image
+{
+public:
+    /**
+     *  \brief Node of the image
+     *
+     *  Internal nodes store index of the variable and position of
+     *  the first son in the array of sons. Terminal nodes
+     *  store \c TerminalIndex and the value.
+     */
+    struct entry
+    {
+        int32 index_;
+        uint32 data_;
+    };
+
+    static constexpr int32 TerminalIndex = -1;
+
+public:
+    /**
+     *  \brief Initializes the image from arrays created by a manager
+     *  \param domains Domains of variables
+     *  \param levels Level of each variable
+     *  \param nodes Nodes ordered by levels, root first
+     *  \param sons Offsets of sons for all internal nodes
+     */
+    diagram_image(
+        std::vector<int32> domains,
+        std::vector<int32> levels,
+        std::vector<entry> nodes,
+        std::vector<uint32> sons
+    );
+
+    /**
+     *  \brief Evaluates the function for given variable values
+     *  \param values Container holding values of variables
+     *  \return Value of the function
+     */
+    template<class Vars>
+    [[nodiscard]] auto evaluate (Vars const& values) const -> int32;
+
+    /**
+     *  \brief Calculates number of variable assignments for which
+     *  the function evaluates to \p value
+     *  \param value Value of the function
+     *  \return Number of assignments
+     */
+    [[nodiscard]] auto satisfy_count (int32 value) const -> int64;
+
+    /**
+     *  \brief Calculates probability that the function evaluates
+     *  to \p value
+     *
+     *  \p probs[i][k] must return probability that i-th variable
+     *  has value k
+     *
+     *  \param value Value of the function
+     *  \param probs Matrix of variable value probabilities
+     *  \return Probability of \p value
+     */
+    template<class Ps>
+    [[nodiscard]] auto calculate_probability (
+        int32 value,
+        Ps const& probs
+    ) const -> double;
+
+    /**
+     *  \return Number of nodes in the image
+     */
+    [[nodiscard]] auto get_node_count () const -> int64;
+
+    /**
+     *  \return Number of variables
+     */
+    [[nodiscard]] auto get_var_count () const -> int32;
+
+    /**
+     *  \brief Enumerates indices of variables that the function depends on
+     *  \return Vector of indices
+     */
+    [[nodiscard]] auto get_dependency_set () const -> std::vector<int32>;
+
+    /**
+     *  \brief Writes the image into a binary file that can be opened
+     *  by \c open
+     *
+     *  Arrays are written as they are in memory so the file can only be
+     *  opened on machines with the same byte order.
+     *
+     *  \param out Binary output stream (e.g. \c std::ofstream opened
+     *  with \c std::ios::binary )
+     */
+    auto save (std::ostream& out) const -> void;
+
+    /**
+     *  \brief Opens image saved by \c save
+     *
+     *  The content is validated in a single pass over the nodes so that
+     *  a corrupted file cannot make queries read outside of the arrays.
+     *
+     *  \param path Path to the file
+     *  \return Optional holding the image or \c std::nullopt if the file
+     *  could not be opened or is not a valid image
+     */
+    [[nodiscard]] static auto open (std::string const& path)
+        -> std::optional<diagram_image>;
+
+private:
+    /**
+     *  \brief Header of the image file, arrays follow right after it
+     */
+    struct file_header
+    {
+        char magic_[8];
+        int32 varCount_;
+        uint32 version_;
+        uint64 nodeCount_;
+        uint64 sonCount_;
+    };
+
+    /**
+     *  \brief Arrays of images created by a manager
+     */
+    struct owned_arrays
+    {
+        std::vector<entry> nodes_;
+        std::vector<uint32> sons_;
+    };
+
+    static constexpr char FileMagic[8] = "TDDYIMG";
+    static constexpr uint32 FileVersion = 1;
+
+private:
+    /**
+     *  \brief Initializes image that views arrays kept alive by \p storage
+     */
+    diagram_image(
+        std::vector<int32> domains,
+        std::vector<int32> levels,
+        std::shared_ptr<void const> storage,
+        entry const* nodes,
+        int64 nodeCount,
+        uint32 const* sons,
+        int64 sonCount
+    );
+
+    /**
+     *  \brief Checks arrays read from a file in a single pass
+     *  \return True if evaluation and all other queries stay within
+     *  the arrays and terminate
+     */
+    [[nodiscard]] static auto is_valid (
+        std::vector<int32> const& domains,
+        std::vector<int32> const& levels,
+        entry const* nodes,
+        file_header const& header,
+        uint32 const* sons
+    ) -> bool;
+
+    /**
+     *  \return Level of the node at \p offset
+     */
+    [[nodiscard]] auto get_level (uint32 offset) const -> int32;
+
+    /**
+     *  \return Product of domains of variables on levels
+     *  from \p levelFrom to \p levelTo (excluded)
+     */
+    [[nodiscard]] auto domain_product (int32 levelFrom, int32 levelTo) const
+        -> int64;
+
+    /**
+     *  \brief Calculates weights of paths from each node to terminal
+     *  with \p value , processing nodes from the last to the first
+     *  \param edgeWeight Function that returns weight of an edge
+     *  from a node to its k-th son
+     *  \return Weight of the root
+     */
+    template<class T, class EdgeWeight>
+    auto bottom_up (int32 value, EdgeWeight edgeWeight) const -> T;
+
+private:
+    std::vector<int32> domains_;
+    std::vector<int32> levels_;
+    std::vector<int32> levelDomains_;
+    std::shared_ptr<void const> storage_;
+    entry const* nodes_;
+    int64 nodeCount_;
+    uint32 const* sons_;
+    int64 sonCount_;
+};
+
+inline diagram_image::diagram_image(
+    std::vector<int32> domains,
+    std::vector<int32> levels,
+    std::vector<entry> nodes,
+    std::vector<uint32> sons
+) :
+    domains_(static_cast<std::vector<int32>&&>(domains)),
+    levels_(static_cast<std::vector<int32>&&>(levels)),
+    levelDomains_(domains_.size()),
+    storage_(),
+    nodes_(nullptr),
+    nodeCount_(static_cast<int64>(nodes.size())),
+    sons_(nullptr),
+    sonCount_(static_cast<int64>(sons.size()))
+{
+    auto arrays = std::make_shared<owned_arrays>(owned_arrays {
+        static_cast<std::vector<entry>&&>(nodes),
+        static_cast<std::vector<uint32>&&>(sons)
+    });
+    nodes_   = arrays->nodes_.data();
+    sons_    = arrays->sons_.data();
+    storage_ = static_cast<std::shared_ptr<owned_arrays>&&>(arrays);
+
+    assert(nodeCount_ > 0);
+    for (std::size_t index = 0; index < domains_.size(); ++index)
+    {
+        levelDomains_[as_uindex(levels_[index])] = domains_[index];
+    }
+}
+
+inline diagram_image::diagram_image(
+    std::vector<int32> domains,
+    std::vector<int32> levels,
+    std::shared_ptr<void const> storage,
+    entry const* const nodes,
+    int64 const nodeCount,
+    uint32 const* const sons,
+    int64 const sonCount
+) :
+    domains_(static_cast<std::vector<int32>&&>(domains)),
+    levels_(static_cast<std::vector<int32>&&>(levels)),
+    levelDomains_(domains_.size()),
+    storage_(static_cast<std::shared_ptr<void const>&&>(storage)),
+    nodes_(nodes),
+    nodeCount_(nodeCount),
+    sons_(sons),
+    sonCount_(sonCount)
+{
+    for (std::size_t index = 0; index < domains_.size(); ++index)
+    {
+        levelDomains_[as_uindex(levels_[index])] = domains_[index];
+    }
+}
+
+template<class Vars>
+auto diagram_image::evaluate(Vars const& values) const -> int32
+{
+    entry const* node = nodes_;
+    while (node->index_ != TerminalIndex)
+    {
+        auto const var   = as_uindex(node->index_);
+        auto const value = static_cast<uint32>(values[var]);
+        node             = nodes_ + sons_[node->data_ + value];
+    }
+    return static_cast<int32>(node->data_);
+}
+
+inline auto diagram_image::satisfy_count(int32 const value) const -> int64
+{
+    int64 const rootCount = this->bottom_up<int64>(
+        value,
+        [this] (uint32 const nodeOffset, uint32 const sonOffset, int32)
+        {
+            return this->domain_product(
+                this->get_level(nodeOffset) + 1,
+                this->get_level(sonOffset)
+            );
+        }
+    );
+    return rootCount * this->domain_product(0, this->get_level(0));
+}
+
+template<class Ps>
+auto diagram_image::calculate_probability(
+    int32 const value,
+    Ps const& probs
+) const -> double
+{
+    return this->bottom_up<double>(
+        value,
+        [this, &probs] (uint32 const nodeOffset, uint32, int32 const k)
+        {
+            auto const index = as_uindex(nodes_[nodeOffset].index_);
+            return static_cast<double>(probs[index][as_uindex(k)]);
+        }
+    );
+}
+
+inline auto diagram_image::get_node_count() const -> int64
+{
+    return nodeCount_;
+}
+
+inline auto diagram_image::get_var_count() const -> int32
+{
+    return static_cast<int32>(domains_.size());
+}
+
+inline auto diagram_image::get_dependency_set() const -> std::vector<int32>
+{
+    std::vector<int32> indices;
+    std::vector<bool> memo(domains_.size(), false);
+    for (int64 i = 0; i < nodeCount_; ++i)
+    {
+        int32 const index = nodes_[i].index_;
+        if (index != TerminalIndex && not memo[as_uindex(index)])
+        {
+            memo[as_uindex(index)] = true;
+            indices.push_back(index);
+        }
+    }
+    return indices;
+}
+
+inline auto diagram_image::save(std::ostream& out) const -> void
+{
+    file_header header {};
+    std::memcpy(header.magic_, FileMagic, sizeof(FileMagic));
+    header.varCount_  = this->get_var_count();
+    header.version_   = FileVersion;
+    header.nodeCount_ = static_cast<uint64>(nodeCount_);
+    header.sonCount_  = static_cast<uint64>(sonCount_);
+
+    auto const write = [&out] (void const* data, std::size_t size)
+    {
+        out.write(
+            static_cast<char const*>(data),
+            static_cast<std::streamsize>(size)
+        );
+    };
+    write(&header, sizeof(header));
+    write(domains_.data(), domains_.size() * sizeof(int32));
+    write(levels_.data(), levels_.size() * sizeof(int32));
+    write(nodes_, as_usize(nodeCount_) * sizeof(entry));
+    write(sons_, as_usize(sonCount_) * sizeof(uint32));
+}
+
+inline auto diagram_image::open(std::string const& path)
+    -> std::optional<diagram_image>
+{
+    // Evaluation jumps between nodes and the mapping can be shared
+    // by processes so read-ahead would only waste page cache.
+    auto file
+        = std::make_shared<mapped_file>(path, mapped_file::access::Random);
+    if (not file->is_open())
+    {
+        return std::nullopt;
+    }
+
+    std::string_view const bytes = file->get_view();
+    file_header header {};
+    if (bytes.size() < sizeof(header))
+    {
+        return std::nullopt;
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    bool const isValidHeader
+        = std::memcmp(header.magic_, FileMagic, sizeof(FileMagic)) == 0
+       && header.version_ == FileVersion && header.varCount_ >= 0
+       && header.nodeCount_ > 0;
+    if (not isValidHeader)
+    {
+        return std::nullopt;
+    }
+
+    // Each count is checked against the remaining size before it is
+    // multiplied so that a corrupted header cannot wrap the total size.
+    uint64 const varCount = static_cast<uint64>(header.varCount_);
+    uint64 rest           = bytes.size() - sizeof(header);
+    if (varCount > rest / (2 * sizeof(int32)))
+    {
+        return std::nullopt;
+    }
+    rest -= 2 * varCount * sizeof(int32);
+
+    if (header.nodeCount_ > rest / sizeof(entry))
+    {
+        return std::nullopt;
+    }
+    rest -= header.nodeCount_ * sizeof(entry);
+
+    if (header.sonCount_ > rest / sizeof(uint32)
+        || rest != header.sonCount_ * sizeof(uint32))
+    {
+        return std::nullopt;
+    }
+
+    // Domains and levels are small so they are copied, nodes and sons
+    // are used right from the file content. All arrays are 4-byte
+    // aligned.
+    char const* position = bytes.data() + sizeof(header);
+    std::vector<int32> domains(varCount);
+    std::vector<int32> levels(varCount);
+    std::memcpy(domains.data(), position, varCount * sizeof(int32));
+    position += varCount * sizeof(int32);
+    std::memcpy(levels.data(), position, varCount * sizeof(int32));
+    position += varCount * sizeof(int32);
+    auto const* const nodes = reinterpret_cast<entry const*>(position);
+    position += header.nodeCount_ * sizeof(entry);
+    auto const* const sons = reinterpret_cast<uint32 const*>(position);
+
+    if (not diagram_image::is_valid(domains, levels, nodes, header, sons))
+    {
+        return std::nullopt;
+    }
+
+    return diagram_image(
+        static_cast<std::vector<int32>&&>(domains),
+        static_cast<std::vector<int32>&&>(levels),
+        static_cast<std::shared_ptr<mapped_file>&&>(file),
+        nodes,
+        static_cast<int64>(header.nodeCount_),
+        sons,
+        static_cast<int64>(header.sonCount_)
+    );
+}
+
+inline auto diagram_image::is_valid(
+    std::vector<int32> const& domains,
+    std::vector<int32> const& levels,
+    entry const* const nodes,
+    file_header const& header,
+    uint32 const* const sons
+) -> bool
+{
+    // Levels must be a permutation and domains must be positive.
+    std::vector<bool> isLevelUsed(levels.size(), false);
+    for (std::size_t index = 0; index < levels.size(); ++index)
+    {
+        int32 const level = levels[index];
+        if (domains[index] < 1 || level < 0
+            || as_usize(level) >= levels.size()
+            || isLevelUsed[as_uindex(level)])
+        {
+            return false;
+        }
+        isLevelUsed[as_uindex(level)] = true;
+    }
+
+    // Sons must follow their parents on deeper levels so evaluation
+    // always ends in a terminal and bottom_up sees sons first. Invalid
+    // index gets level -1 so that it is rejected as a son as well.
+    auto const levelOf = [&levels, nodes] (uint64 const offset)
+    {
+        int32 const index = nodes[offset].index_;
+        if (index == TerminalIndex)
+        {
+            return static_cast<int32>(levels.size());
+        }
+        return index < 0 || as_usize(index) >= levels.size()
+                 ? -1
+                 : levels[as_uindex(index)];
+    };
+    for (uint64 offset = 0; offset < header.nodeCount_; ++offset)
+    {
+        int32 const index = nodes[offset].index_;
+        if (index == TerminalIndex)
+        {
+            continue;
+        }
+        int32 const level = levelOf(offset);
+        if (level == -1)
+        {
+            return false;
+        }
+
+        auto const domain     = static_cast<uint64>(domains[as_uindex(index)]);
+        uint64 const firstSon = nodes[offset].data_;
+        if (firstSon + domain > header.sonCount_)
+        {
+            return false;
+        }
+        for (uint64 k = 0; k < domain; ++k)
+        {
+            uint64 const son = sons[firstSon + k];
+            if (son <= offset || son >= header.nodeCount_
+                || levelOf(son) <= level)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+inline auto diagram_image::get_level(uint32 const offset) const -> int32
+{
+    int32 const index = nodes_[offset].index_;
+    return index == TerminalIndex ? this->get_var_count()
+                                  : levels_[as_uindex(index)];
+}
+
+inline auto diagram_image::domain_product(
+    int32 const levelFrom,
+    int32 const levelTo
+) const -> int64
+{
+    int64 product = 1;
+    for (int32 level = levelFrom; level < levelTo; ++level)
+    {
+        product *= levelDomains_[as_uindex(level)];
+    }
+    return product;
+}
+
+template<class T, class EdgeWeight>
+auto diagram_image::bottom_up(int32 const value, EdgeWeight edgeWeight) const
+    -> T
+{
+    // Sons always follow their parents so a single backward pass
+    // visits each node after all of its sons.
+    std::vector<T> weights(as_usize(nodeCount_), T(0));
+    for (auto i = as_usize(nodeCount_); i > 0; --i)
+    {
+        auto const offset = static_cast<uint32>(i - 1);
+        entry const& node = nodes_[offset];
+        if (node.index_ == TerminalIndex)
+        {
+            bool const isValue = static_cast<int32>(node.data_) == value;
+            weights[offset]    = isValue ? T(1) : T(0);
+            continue;
+        }
+
+        T weight           = T(0);
+        int32 const domain = domains_[as_uindex(node.index_)];
+        for (int32 k = 0; k < domain; ++k)
+        {
+            uint32 const son  = sons_[node.data_ + static_cast<uint32>(k)];
+            weight           += edgeWeight(offset, son, k) * weights[son];
+        }
+        weights[offset] = weight;
+    }
+    return weights[0];
+}
+} // namespace teddy
+
+#endif
@@ -1,20 +1,30 @@
 #ifndef LIBTEDDY_DETAILS_DIAGRAM_MANAGER_HPP
 #define LIBTEDDY_DETAILS_DIAGRAM_MANAGER_HPP
 
+#include <libteddy/details/big_uint.hpp>
 #include <libteddy/details/diagram.hpp>
+#include <libteddy/details/diagram_image.hpp>
 #include <libteddy/details/node_manager.hpp>
 #include <libteddy/details/operators.hpp>
 #include <libteddy/details/pla_file.hpp>
+#include <libteddy/details/satisfying_iterator.hpp>
 #include <libteddy/details/stats.hpp>
 #include <libteddy/details/tools.hpp>
 #include <libteddy/details/types.hpp>
+#include <libteddy/details/varint.hpp>
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <concepts>
 #include <initializer_list>
+#include <limits>
 #include <iterator>
 #include <optional>
+#include <random>
 #include <ranges>
+#include <span>
+#include <string_view>
 #include <vector>
 
 namespace teddy
@@ -81,6 +91,9 @@ struct var_cofactor
     int32 value_;
 };
 
+template<class Degree, class Domain>
+class add_manager;
+
 /**
  *  \class diagram_manager
  *  \brief Base class for all diagram managers that generically
@@ -235,6 +248,19 @@ public:
     template<std::output_iterator<teddy::int32> O>
     auto to_vector_g (diagram_t const& diagram, O out) const -> void;
 
+    /**
+     *  \brief Writes truth vector of the diagram into \p out
+     *
+     *  Blocks of the vector that correspond to terminal nodes are filled
+     *  at once and blocks of skipped levels are copies of the first
+     *  block, so the function is not evaluated for each element.
+     *
+     *  \param diagram Diagram
+     *  \param out Buffer with the size of the truth vector
+     */
+    auto to_vector_into (diagram_t const& diagram, std::span<int32> out) const
+        -> void;
+
     /**
      *  \brief Creates BDDs defined by PLA file.
      *
@@ -248,6 +274,24 @@ public:
     auto from_pla (pla_file const& file, fold_type foldType = fold_type::Tree)
         -> utils::second_t<Foo, std::vector<diagram_t>>;
 
+    /**
+     *  \brief Creates BDDs defined by PLA file at given path.
+     *
+     *  Unlike \c from_pla , lines of the file are not stored. Each line
+     *  is turned into a product as soon as it is parsed and products
+     *  are merged into the functions in small batches so that the peak
+     *  memory is given by the diagrams rather than by the file.
+     *
+     *  \tparam Foo Dummy template to enable SFINE.
+     *  \param path Path to the PLA file.
+     *  \return Optional holding vector of diagrams or \c std::nullopt
+     *  if the file could not be loaded.
+     */
+    template<class Foo = void>
+    requires(is_bdd<Degree>)
+    auto from_pla_file (std::string const& path)
+        -> utils::second_t<Foo, std::optional<std::vector<diagram_t>>>;
+
     /**
      *  \brief Creates diagram from an expression tree (AST).
      *  \tparam Node Node type of the tree.
@@ -303,11 +347,52 @@ public:
     auto apply (diagram_t const& lhs, diagram_t const& rhs) -> diagram_t;
 
     /**
-     *  \brief TODO
+     *  \brief Merges diagams using the \c Op operation in a single pass
+     *
+     *  Results are memoized in the cache of the manager so repeated calls
+     *  with the same operands are cheap.
+     *
+     *  \tparam Op Binary operation
+     *  \param diagrams Diagrams to merge
+     *  \return Diagram representing merger of all \p diagrams
      */
     template<teddy_bin_op Op, class... Diagram>
     auto apply_n (Diagram const&... diagrams) -> diagram_t;
 
+    /**
+     *  \brief Creates diagram of if-then-else
+     *
+     *  Result has the value of \p g where \p f is 1 and the value
+     *  of \p h where \p f is 0. It is computed in a single pass
+     *  with results memoized under all three operands.
+     *
+     *  \tparam Foo Dummy template to enable SFINE.
+     *  \param f Condition
+     *  \param g Diagram used where \p f is 1
+     *  \param h Diagram used where \p f is 0
+     *  \return Diagram representing ite( \p f , \p g , \p h )
+     */
+    template<class Foo = void>
+    requires(is_bdd<Degree>)
+    auto ite (diagram_t const& f, diagram_t const& g, diagram_t const& h)
+        -> utils::second_t<Foo, diagram_t>;
+
+    /**
+     *  \brief Creates diagram that selects one of \p cases
+     *  by the value of \p selector
+     *
+     *  Result has the value of \p cases [k] where \p selector has
+     *  value k. Generalizes \c ite to multiple-valued selectors.
+     *
+     *  \param selector Diagram that selects the case
+     *  \param cases Diagrams, one for each value of \p selector
+     *  \return Diagram representing the multiplexer
+     */
+    auto multiplex (
+        diagram_t const& selector,
+        std::vector<diagram_t> const& cases
+    ) -> diagram_t;
+
     // TODO apply_own
 
     /**
@@ -419,18 +504,124 @@ public:
     template<in_var_values Vars>
     auto evaluate (diagram_t const& diagram, Vars const& values) const -> int32;
 
+    /**
+     *  \brief Evaluates the function for many variable assignments
+     *
+     *  Assignments are evaluated in small groups. Traversals of a group
+     *  are interleaved and the next node of each traversal is prefetched
+     *  so that memory accesses of different assignments overlap. This is
+     *  faster than calling \c evaluate in a loop for large diagrams.
+     *
+     *  \tparam Matrix Random access range of variable assignments
+     *  \tparam O Output iterator type
+     *  \param diagram Diagram
+     *  \param values Range of variable assignments
+     *  \param out Output iterator that receives values of the function
+     *  in the same order as the assignments
+     */
+    template<
+        std::ranges::random_access_range Matrix,
+        std::output_iterator<int32> O>
+    requires in_var_values<std::ranges::range_value_t<Matrix>>
+    auto evaluate_batch (
+        diagram_t const& diagram,
+        Matrix const& values,
+        O out
+    ) const -> void;
+
+    /**
+     *  \brief Creates read-only image of the diagram
+     *
+     *  The image is a copy of the diagram stored in contiguous arrays
+     *  that does not refer to the manager. It is useful when the same
+     *  diagram is queried many times, possibly from multiple threads.
+     *  Later changes of the variable order do not affect the image.
+     *  Nodes and sons are referenced by 32-bit offsets so the diagram
+     *  must have less than 2^31 nodes with less than 2^32 sons in total.
+     *
+     *  \param diagram Diagram
+     *  \return Image of the diagram
+     */
+    auto make_image (diagram_t const& diagram) const -> diagram_image;
+
+    /**
+     *  \brief Writes diagrams into a compact binary format
+     *
+     *  The header stores domains and the order of variables. Nodes
+     *  shared by multiple diagrams are stored only once. Nodes are
+     *  grouped by levels from the bottom and sons are stored
+     *  as variable-length distances to their parents.
+     *
+     *  \param diagrams Diagrams to save
+     *  \param out Binary output stream (e.g. \c std::ofstream opened
+     *  with \c std::ios::binary )
+     */
+    auto save (std::vector<diagram_t> const& diagrams, std::ostream& out) const
+        -> void;
+
+    /**
+     *  \brief Reads diagrams written by \c save
+     *
+     *  Nodes are inserted directly into the unique tables, no apply
+     *  is used. Domains and the order of variables of the manager must
+     *  be the same as those stored in the header.
+     *
+     *  \param in Binary input stream
+     *  \return Optional holding diagrams in the same order as they were
+     *  saved or \c std::nullopt if the input is invalid or
+     *  the header does not match the manager
+     */
+    auto load (std::istream& in) -> std::optional<std::vector<diagram_t>>;
+
+    /**
+     *  \brief Imports diagram from another manager of the same type
+     *
+     *  The managers can have different variable orders and node pools.
+     *  Each node of \p diagram is imported only once and is rebuilt
+     *  in the order of this manager as \c multiplex of its variable
+     *  and its imported sons, so sharing of the source diagram is
+     *  preserved. Domains of variables must be the same in both managers.
+     *
+     *  \param diagram Diagram owned by \p from
+     *  \param from Manager that owns \p diagram
+     *  \return Diagram representing the same function in this manager
+     */
+    auto transfer (diagram_t const& diagram, diagram_manager const& from)
+        -> diagram_t;
+
     /**
      *  \brief Calculates number of variable assignments for which
      *  the functions evaluates to certain value
      *
      *  Complexity is \c O(|d|) where \c |d| is the number of nodes.
+     *  The count can easily exceed 64 bits for functions of many variables.
+     *  In that case use a wider \p Int, e.g., \c big_uint or \c double
+     *  for an approximate result.
      *
+     *  \tparam Int Type of the count. Must be constructible from \c int64
+     *  and support \c += and \c *
      *  \param value Value of the function
      *  \param diagram Diagram representing the function
      *  \return Number of different variable assignments for which the
      *  the function represented by \p d evaluates to \p val
      */
-    auto satisfy_count (int32 value, diagram_t const& diagram) -> int64;
+    template<class Int = int64>
+    auto satisfy_count (int32 value, diagram_t const& diagram) -> Int;
+
+    /**
+     *  \brief Calculates number of variable assignments for each value
+     *  of the function
+     *
+     *  Counts for all values are calculated in a single traversal
+     *  which is cheaper than calling \c satisfy_count for each value.
+     *
+     *  \tparam Int Type of the counts, see \c satisfy_count
+     *  \param diagram Diagram representing the function
+     *  \return Vector where i-th element is the number of variable
+     *  assignments for which the function evaluates to i
+     */
+    template<class Int = int64>
+    auto satisfy_counts (diagram_t const& diagram) -> std::vector<Int>;
 
     /**
      *  \brief Finds variable assignment for which diagram evaluates to \p value
@@ -492,6 +683,52 @@ public:
     auto satisfy_all_g (int32 value, diagram_t const& diagram, O out) const
         -> void;
 
+    /**
+     *  \brief Lazily enumerates variable assignments for which
+     *  the function evaluates to \p value
+     *
+     *  Unlike \c satisfy_all, assignments are not stored, each one is
+     *  calculated when the iterator is incremented. In the \c Cubes mode,
+     *  variables that are skipped in a path have value \c DontCare
+     *  so that a single cube might represent many assignments.
+     *  Diagram must stay alive while the range is in use and the manager
+     *  must not collect garbage or reorder variables in the meantime.
+     *
+     *  \param value Value of the function
+     *  \param diagram Diagram representing the function
+     *  \param mode Specifies whether to yield assignments or cubes
+     *  \return Range of vectors of variable values
+     */
+    auto satisfy_range (
+        int32 value,
+        diagram_t const& diagram,
+        satisfy_mode mode = satisfy_mode::Assignments
+    ) const -> satisfying_range<Data, Degree, Domain>;
+
+    /**
+     *  \brief Draws random variable assignments for which the function
+     *  evaluates to \p value
+     *
+     *  Each assignment from the satisfying set is drawn with the same
+     *  probability. Probabilities of paths are calculated in a single
+     *  traversal of the diagram, then each sample takes \c O(n) steps
+     *  where \c n is the number of variables.
+     *
+     *  \param value Value of the function
+     *  \param diagram Diagram representing the function
+     *  \param rng Uniform random bit generator
+     *  \param count Number of samples
+     *  \return Vector of \p count assignments or empty vector
+     *  if the satisfying set is empty
+     */
+    template<class Rng>
+    auto sample_satisfying (
+        int32 value,
+        diagram_t const& diagram,
+        Rng& rng,
+        int64 count
+    ) -> std::vector<std::vector<int32>>;
+
     /**
      *  \brief Calculates cofactor of the functions
      *
@@ -709,28 +946,29 @@ protected:
     using node_t        = typename diagram<Data, Degree>::node_t;
     using son_container = typename node_t::son_container;
 
-private:
-    template<int32 Size>
-    struct node_pack
-    {
-        node_t* key_[static_cast<std::size_t>(Size)] {nullptr};
-        node_t* result_ {nullptr};
-    };
+protected:
+    /*
+     *  Ids of operations memoized in the computed table of the node manager.
+     *  Operations that are parametrized by a function object get a fresh id
+     *  from the node manager for each call.
+     */
+    static constexpr int32 COFACTOR_OP_ID  = 1;
+    static constexpr int32 NEGATE_OP_ID    = 2;
+    static constexpr int32 TO_DPLD_E_OP_ID = 3;
+    static constexpr int32 TO_MNF_OP_ID    = 4;
 
-    // TODO tmp
-    template<int32 Size, class... Node>
-    static auto pack_equals (node_pack<Size> const& pack, Node... nodes)
-    {
-        node_t* nodeArray[] {nodes...};
-        for (int32 k = 0; k < Size; ++k)
-        {
-            if (pack.key_[k] != nodeArray[k])
-            {
-                return false;
-            }
-        }
-        return true;
-    }
+    /*
+     *  Ids of operations memoized in the n-ary cache. They must not
+     *  collide with ids of binary operations from \c ops .
+     */
+    static constexpr int32 ITE_OP_ID       = 1'000;
+    static constexpr int32 MULTIPLEX_OP_ID = 1'001;
+
+    /*
+     *  Header of the binary format used by \c save and \c load .
+     */
+    static constexpr std::string_view BINARY_MAGIC = "TDDY";
+    static constexpr uint64 BINARY_VERSION         = 1;
 
 private:
     // TODO namiesto mema by sa dali pouzit data,
@@ -742,11 +980,28 @@ private:
     auto apply_impl (Op operation, node_t* lhs, node_t* rhs) -> node_t*;
 
     template<class Op, class... Node>
-    auto apply_n_impl (
-        std::vector<node_pack<sizeof...(Node)>>& cache,
-        Op operation,
-        Node... nodes
-    ) -> node_t*;
+    auto apply_n_impl (int32 opId, Op operation, Node... nodes) -> node_t*;
+
+    /**
+     *  \brief Runs \c multiplex_impl and releases constants it created
+     *  during normalization but did not use
+     *  \param operands Selector followed by cases
+     */
+    template<class Operands>
+    auto multiplex_root (int32 opId, Operands operands) -> node_t*;
+
+    /**
+     *  \brief Selects one of the operands by the value of the first one
+     *  \param operands Selector followed by cases
+     */
+    template<class Operands>
+    auto multiplex_impl (int32 opId, Operands operands) -> node_t*;
+
+    /**
+     *  \return True if case \p k equal to the selector can be replaced
+     *  by the constant \p k
+     */
+    [[nodiscard]] static auto is_constant_case (int32 k) -> bool;
 
     template<class Vars>
     auto satisfy_one_impl (int32 value, Vars& vars, node_t* node) -> bool;
@@ -760,32 +1015,102 @@ private:
         int32 level
     ) const -> void;
 
-    auto get_cofactor_impl (
-        std::unordered_map<node_t*, node_t*>& memo,
-        int32 varIndex,
-        int32 varValue,
-        node_t* node
-    ) -> node_t*;
+    auto get_cofactor_impl (int32 varIndex, int32 varValue, node_t* node)
+        -> node_t*;
 
     auto get_cofactor_impl (
-        std::unordered_map<node_t*, node_t*>& memo,
+        int32 opId,
         std::vector<var_cofactor> const& vars,
         node_t* node,
         int32 toCofactor
     ) -> node_t*;
 
     template<class F>
-    auto transform_impl (
-        std::unordered_map<node_t*, node_t*>& memo,
-        F transformer,
-        node_t* node
-    ) -> node_t*;
+    auto transform_impl (int32 opId, F transformer, node_t* node) -> node_t*;
 
     template<class ExprNode>
-    auto from_expression_tree_impl (
-        std::vector<node_pack<2>>& cache,
-        ExprNode const& exprNode
-    ) -> node_t*;
+    auto from_expression_tree_impl (ExprNode const& exprNode) -> node_t*;
+
+    /**
+     *  \brief Creates product of literals from a PLA cube
+     *
+     *  Product is a chain of nodes, one for each literal. It is built
+     *  bottom-up in level order without apply.
+     */
+    auto pla_product (bool_cube const& cube) -> diagram_t;
+
+    /**
+     *  \brief Writes block of the truth vector that starts at \p level
+     *  and belongs to \p node into \p out
+     *  \param blockSizes Size of the block on each level
+     */
+    auto to_vector_into_impl (
+        node_t* node,
+        int32 level,
+        std::vector<int64> const& blockSizes,
+        int32* out
+    ) const -> void;
+
+    template<class Int>
+    auto domain_product_as (int32 levelFrom, int32 levelTo) const -> Int;
+
+protected:
+    /**
+     *  \brief Draws random variable assignments for which the function
+     *  evaluates to \p value
+     *
+     *  \param varProb Function that returns relative probability that
+     *  a variable (first argument) has a value (second argument)
+     */
+    template<class Rng, class VarProb>
+    auto sample_satisfying_impl (
+        int32 value,
+        node_t* root,
+        Rng& rng,
+        int64 count,
+        VarProb varProb
+    ) -> std::vector<std::vector<int32>>;
+
+    /**
+     *  \brief Calculates weights of paths from \p root to each terminal
+     *
+     *  Weight of a path is the product of weights of its edges.
+     *  Each node gets a vector of accumulators, one for each function value,
+     *  that are stored next to each other in a single array. The number of
+     *  accumulators is a compile time constant for fixed domains.
+     *
+     *  \param root Root of the diagram
+     *  \param edgeWeight Function that returns weight of the edge
+     *  from a node to its k-th son
+     *  \return Vector where i-th element is the sum of weights of paths
+     *  from \p root to the terminal with value i
+     */
+    template<class T, class EdgeWeight>
+    auto terminal_weights (node_t* root, EdgeWeight edgeWeight)
+        -> std::vector<T>;
+
+    /**
+     *  \brief Calculates weights of paths from each of \p roots
+     *  to each terminal
+     *
+     *  Nodes shared by multiple diagrams are processed only once.
+     *
+     *  \param roots Roots of the diagrams
+     *  \param edgeWeight Function that returns weight of the edge
+     *  from a node to its k-th son
+     *  \return Vector where i-th element is the result of
+     *  \c terminal_weights for the i-th root
+     */
+    template<class T, class EdgeWeight>
+    auto terminal_weights (
+        std::vector<node_t*> const& roots,
+        EdgeWeight edgeWeight
+    ) -> std::vector<std::vector<T>>;
+
+    /**
+     *  \return Number of possible function values
+     */
+    [[nodiscard]] auto get_value_count () const -> int32;
 
 protected:
     /**
@@ -837,6 +1162,10 @@ public:
 
 protected:
     node_manager<Data, Degree, Domain> nodes_;
+
+    // Converts diagrams by traversing nodes of this manager.
+    template<class Dg, class Dm>
+    friend class add_manager;
 };
 
 template<class Data, class Degree, class Domain>
@@ -972,17 +1301,65 @@ auto diagram_manager<Data, Degree, Domain>::from_vector(I first, S last)
         }
     };
 
-    while (first != last)
+    if constexpr (std::forward_iterator<I>)
+    {
+        // Runs of equal values are pushed as terminals on the highest
+        // level whose aligned block fits into the run, so constant blocks
+        // of the vector are skipped without creating any nodes.
+        int32 const leafLevel = lastLevel + 1;
+        std::vector<int64> blockSizes(as_usize(leafLevel + 1), 1);
+        for (int32 level = lastLevel; level >= 0; --level)
+        {
+            blockSizes[as_uindex(level)]
+                = blockSizes[as_uindex(level + 1)]
+                * nodes_.get_domain(nodes_.get_index(level));
+        }
+
+        I runLast        = first;
+        int64 position   = 0;
+        int64 runLastPos = 0;
+        while (first != last)
+        {
+            if (runLastPos == position)
+            {
+                auto const value = *first;
+                do
+                {
+                    ++runLast;
+                    ++runLastPos;
+                } while (runLast != last && *runLast == value);
+            }
+
+            int64 const runLength = runLastPos - position;
+            int32 level           = leafLevel;
+            while (level > 0
+                   && blockSizes[as_uindex(level - 1)] <= runLength
+                   && position % blockSizes[as_uindex(level - 1)] == 0)
+            {
+                --level;
+            }
+
+            node_t* const node = nodes_.make_terminal_node(*first);
+            stack.push_back(stack_frame {node, level});
+            shrink_stack();
+            std::ranges::advance(first, blockSizes[as_uindex(level)]);
+            position += blockSizes[as_uindex(level)];
+        }
+    }
+    else
     {
-        int32 const lastDomain = nodes_.get_domain(lastIndex);
-        son_container sons     = nodes_.make_son_container(lastDomain);
-        for (int32 k = 0; k < lastDomain; ++k)
+        while (first != last)
         {
-            sons[k] = nodes_.make_terminal_node(*first++);
+            int32 const lastDomain = nodes_.get_domain(lastIndex);
+            son_container sons     = nodes_.make_son_container(lastDomain);
+            for (int32 k = 0; k < lastDomain; ++k)
+            {
+                sons[k] = nodes_.make_terminal_node(*first++);
+            }
+            node_t* const node = nodes_.make_internal_node(lastIndex, sons);
+            stack.push_back(stack_frame {node, lastLevel});
+            shrink_stack();
         }
-        node_t* const node = nodes_.make_internal_node(lastIndex, sons);
-        stack.push_back(stack_frame {node, lastLevel});
-        shrink_stack();
     }
 
     assert(ssize(stack) == 1);
@@ -1000,12 +1377,72 @@ template<class Data, class Degree, class Domain>
 auto diagram_manager<Data, Degree, Domain>::to_vector(diagram_t const& diagram
 ) const -> std::vector<int32>
 {
-    std::vector<int32> vector;
-    vector.reserve(as_usize(nodes_.domain_product(0, this->get_var_count())));
-    this->to_vector_g(diagram, std::back_inserter(vector));
+    std::vector<int32> vector(
+        as_usize(nodes_.domain_product(0, this->get_var_count()))
+    );
+    this->to_vector_into(diagram, vector);
     return vector;
 }
 
+template<class Data, class Degree, class Domain>
+auto diagram_manager<Data, Degree, Domain>::to_vector_into(
+    diagram_t const& diagram,
+    std::span<int32> const out
+) const -> void
+{
+    int32 const leafLevel = nodes_.get_leaf_level();
+    std::vector<int64> blockSizes(as_usize(leafLevel + 1), 1);
+    for (int32 level = leafLevel - 1; level >= 0; --level)
+    {
+        blockSizes[as_uindex(level)]
+            = blockSizes[as_uindex(level + 1)]
+            * nodes_.get_domain(nodes_.get_index(level));
+    }
+
+    assert(static_cast<int64>(out.size()) == blockSizes[0]);
+    this->to_vector_into_impl(
+        diagram.unsafe_get_root(),
+        0,
+        blockSizes,
+        out.data()
+    );
+}
+
+template<class Data, class Degree, class Domain>
+auto diagram_manager<Data, Degree, Domain>::to_vector_into_impl(
+    node_t* const node,
+    int32 const level,
+    std::vector<int64> const& blockSizes,
+    int32* const out
+) const -> void
+{
+    int64 const blockSize = blockSizes[as_uindex(level)];
+    if (node->is_terminal())
+    {
+        std::fill(out, out + blockSize, node->get_value());
+        return;
+    }
+
+    int32 const index    = nodes_.get_index(level);
+    int32 const domain   = nodes_.get_domain(index);
+    int64 const sonSize  = blockSizes[as_uindex(level + 1)];
+    bool const isSkipped = nodes_.get_level(node) > level;
+    for (int32 k = 0; k < domain; ++k)
+    {
+        int32* const sonOut = out + k * sonSize;
+        if (isSkipped && k > 0)
+        {
+            // Function does not depend on the skipped variable.
+            std::copy(out, out + sonSize, sonOut);
+        }
+        else
+        {
+            node_t* const son = isSkipped ? node : node->get_son(k);
+            this->to_vector_into_impl(son, level + 1, blockSizes, sonOut);
+        }
+    }
+}
+
 template<class Data, class Degree, class Domain>
 template<std::output_iterator<teddy::int32> O>
 auto diagram_manager<Data, Degree, Domain>::to_vector_g(
@@ -1051,22 +1488,20 @@ auto diagram_manager<Data, Degree, Domain>::from_pla(
     fold_type const foldType
 ) -> utils::second_t<Foo, std::vector<diagram_t>>
 {
-    auto const product = [this] (auto const& cube)
+    // Sorting cubes in level order puts cubes with common literals
+    // next to each other so that the fold merges similar products first.
+    auto const cubeLess = [this] (bool_cube const& lhs, bool_cube const& rhs)
     {
-        std::vector<diagram_t> variables;
-        variables.reserve(cube.size());
-        for (int32 i = 0; i < cube.size(); ++i)
+        for (int32 level = 0; level < nodes_.get_leaf_level(); ++level)
         {
-            if (cube.get(i) == 1)
-            {
-                variables.emplace_back(this->variable(i));
-            }
-            else if (cube.get(i) == 0)
+            int32 const index = nodes_.get_index(level);
+            if (index < lhs.size() && index < rhs.size()
+                && lhs.get(index) != rhs.get(index))
             {
-                variables.emplace_back(this->variable_not(i));
+                return lhs.get(index) < rhs.get(index);
             }
         }
-        return this->left_fold<ops::AND>(variables);
+        return false;
     };
 
     auto const orFold = [this, foldType] (auto& diagrams)
@@ -1085,25 +1520,66 @@ auto diagram_manager<Data, Degree, Domain>::from_pla(
         }
     };
 
+#ifdef LIBTEDDY_COLLECT_STATS
+    stats::tick(stats::get_stats().plaBuild_);
+#endif
+
     auto const& plaLines      = file.get_lines();
     int64 const lineCount     = file.get_line_count();
     int64 const functionCount = file.get_function_count();
 
-    // Create a diagram for each function.
+    // We are doing SOP so we are only interested in cubes
+    // with value 1 of at least one function.
+    std::vector<int64> lineIndices;
+    for (int64 li = 0; li < lineCount; ++li)
+    {
+        bool_cube const& fVals = plaLines[as_uindex(li)].fVals_;
+        for (int32 fi = 0; fi < functionCount; ++fi)
+        {
+            if (fVals.get(fi) == 1)
+            {
+                lineIndices.push_back(li);
+                break;
+            }
+        }
+    }
+    utils::sort(
+        lineIndices,
+        [&plaLines, &cubeLess] (int64 const lhs, int64 const rhs)
+        {
+            return cubeLess(
+                plaLines[as_uindex(lhs)].cube_,
+                plaLines[as_uindex(rhs)].cube_
+            );
+        }
+    );
+
+    // Each product is created only once and shared by all functions.
+    // Sorting puts repeated cubes next to each other so they share it too.
+    std::vector<diagram_t> lineProducts;
+    lineProducts.reserve(lineIndices.size());
+    for (std::size_t i = 0; i < lineIndices.size(); ++i)
+    {
+        bool_cube const& cube = plaLines[as_uindex(lineIndices[i])].cube_;
+        bool const isRepeated
+            = i > 0 && cube == plaLines[as_uindex(lineIndices[i - 1])].cube_;
+        lineProducts.emplace_back(
+            isRepeated ? lineProducts.back() : this->pla_product(cube)
+        );
+    }
+    nodes_.run_deferred();
+
+    // Create a diagram for each function by merging its products using OR.
     std::vector<diagram_t> functionDiagrams;
-    functionDiagrams.reserve(functionCount);
+    functionDiagrams.reserve(as_usize(functionCount));
     for (int32 fi = 0; fi < functionCount; ++fi)
     {
-        // First create a diagram for each product.
         std::vector<diagram_t> products;
-        // products.reserve(lineCount);
-        for (int32 li = 0; li < lineCount; ++li)
+        for (std::size_t i = 0; i < lineIndices.size(); ++i)
         {
-            // We are doing SOP so we are only interested
-            // in functions with value 1.
-            if (plaLines[as_usize(li)].fVals_.get(fi) == 1)
+            if (plaLines[as_uindex(lineIndices[i])].fVals_.get(fi) == 1)
             {
-                products.emplace_back(product(plaLines[li].cube_));
+                products.push_back(lineProducts[i]);
             }
         }
 
@@ -1113,63 +1589,231 @@ auto diagram_manager<Data, Degree, Domain>::from_pla(
             products.emplace_back(this->constant(0));
         }
 
-        // Then merge products using OR.
         functionDiagrams.emplace_back(orFold(products));
     }
 
-    return functionDiagrams;
-}
+#ifdef LIBTEDDY_COLLECT_STATS
+    stats::tock(stats::get_stats().plaBuild_);
+#endif
 
-template<class Data, class Degree, class Domain>
-template<expression_node Node>
-auto diagram_manager<Data, Degree, Domain>::from_expression_tree(
-    Node const& root
-) -> diagram_t
-{
-    int64 constexpr CacheCapacity = 100'000;
-    std::vector<node_pack<2>> cache(as_usize(CacheCapacity));
-    node_t* newRoot = this->from_expression_tree_impl(cache, root);
-    nodes_.run_deferred();
-    return diagram_t(newRoot);
+    return functionDiagrams;
 }
 
 template<class Data, class Degree, class Domain>
-template<class ExprNode>
-auto diagram_manager<Data, Degree, Domain>::from_expression_tree_impl(
-    std::vector<node_pack<2>>& cache,
-    ExprNode const& exprNode
-) -> node_t*
+template<class Foo>
+requires(is_bdd<Degree>)
+auto diagram_manager<Data, Degree, Domain>::from_pla_file(
+    std::string const& path
+) -> utils::second_t<Foo, std::optional<std::vector<diagram_t>>>
 {
-    if (exprNode.is_constant())
+    // Products of each function wait in a bounded buffer
+    // which is merged into the function when it is full.
+    std::size_t constexpr BatchSize = 64;
+    std::vector<diagram_t> functionDiagrams;
+    std::vector<std::vector<diagram_t>> batches;
+    auto const merge = [this, &functionDiagrams, &batches] (std::size_t fi)
     {
-        return nodes_.make_terminal_node(exprNode.get_value());
-    }
+        batches[fi].push_back(functionDiagrams[fi]);
+        functionDiagrams[fi] = this->tree_fold<ops::OR>(batches[fi]);
+        batches[fi].clear();
+    };
 
-    if (exprNode.is_variable())
+    auto const init = [this, &functionDiagrams, &batches] (int32 fCount)
     {
-        return this->variable_impl(exprNode.get_index());
-    }
-
-    assert(exprNode.is_operation());
+        functionDiagrams.assign(as_usize(fCount), this->constant(0));
+        batches.resize(as_usize(fCount));
+    };
 
-    node_t* const left
-        = this->from_expression_tree_impl(cache, exprNode.get_left());
-    node_t* const right
-        = this->from_expression_tree_impl(cache, exprNode.get_right());
-    auto const operation = [&exprNode] (auto const lhs, auto const rhs)
-    {
-        if (lhs == Nondetermined || rhs == Nondetermined)
+    std::optional<pla_file::pla_header> const header = pla_file::scan_file(
+        path,
+        [this, &functionDiagrams, &batches, &merge, &init] (
+            pla_file::pla_line const& line
+        )
         {
-            return Nondetermined;
+            int32 const functionCount = line.fVals_.size();
+            if (functionDiagrams.empty())
+            {
+                init(functionCount);
+            }
+
+            // Each product is created only once and shared by all functions.
+            std::optional<diagram_t> product;
+            for (int32 fi = 0; fi < functionCount; ++fi)
+            {
+                if (line.fVals_.get(fi) != 1)
+                {
+                    continue;
+                }
+
+                if (not product)
+                {
+                    product = this->pla_product(line.cube_);
+                }
+
+                std::vector<diagram_t>& batch = batches[as_uindex(fi)];
+                batch.push_back(*product);
+                if (batch.size() == BatchSize)
+                {
+                    merge(as_uindex(fi));
+                }
+            }
+        }
+    );
+
+    if (not header)
+    {
+        return std::nullopt;
+    }
+
+    if (functionDiagrams.empty())
+    {
+        // File without lines, all functions are constant.
+        init(header->functionCount_);
+    }
+
+    for (std::size_t fi = 0; fi < batches.size(); ++fi)
+    {
+        if (not batches[fi].empty())
+        {
+            merge(fi);
+        }
+    }
+    nodes_.run_deferred();
+
+    return std::optional<std::vector<diagram_t>>(
+        static_cast<std::vector<diagram_t>&&>(functionDiagrams)
+    );
+}
+
+template<class Data, class Degree, class Domain>
+auto diagram_manager<Data, Degree, Domain>::transfer(
+    diagram_t const& diagram,
+    diagram_manager const& from
+) -> diagram_t
+{
+    assert(&from != this);
+    assert(from.get_var_count() <= this->get_var_count());
+#ifndef NDEBUG
+    for (int32 index = 0; index < from.get_var_count(); ++index)
+    {
+        assert(from.nodes_.get_domain(index) == nodes_.get_domain(index));
+    }
+#endif
+
+    // Imported node of each source node is kept in the slot given
+    // by the id of the source node.
+    std::vector<node_t*> imported;
+    std::vector<node_t*> selectors;
+    std::vector<node_t*> operands;
+    from.nodes_.traverse_post_numbered(
+        diagram.unsafe_get_root(),
+        [this, &imported, &selectors, &operands] (node_t* const node)
+        {
+            if (node->is_terminal())
+            {
+                imported.push_back(
+                    nodes_.make_terminal_node(node->get_value())
+                );
+                return;
+            }
+
+            int32 const index  = node->get_index();
+            int32 const domain = nodes_.get_domain(index);
+            operands.clear();
+            operands.push_back(this->variable_impl(index));
+            for (int32 k = 0; k < domain; ++k)
+            {
+                node_t* const son = node->get_son(k);
+                operands.push_back(imported[as_uindex(son->get_scratch())]);
+            }
+            selectors.push_back(operands[0]);
+            imported.push_back(
+                this->multiplex_root(MULTIPLEX_OP_ID, operands)
+            );
+        }
+    );
+    diagram_t result(imported.back());
+
+    // Variables and imported nodes that did not become sons
+    // are still marked. They are released as garbage.
+    for (std::vector<node_t*> const* nodes : {&imported, &selectors})
+    {
+        for (node_t* const node : *nodes)
+        {
+            if (node->is_marked())
+            {
+                static_cast<void>(diagram_t(node));
+            }
+        }
+    }
+    nodes_.run_deferred();
+    return result;
+}
+
+template<class Data, class Degree, class Domain>
+auto diagram_manager<Data, Degree, Domain>::pla_product(bool_cube const& cube)
+    -> diagram_t
+{
+    node_t* node = nodes_.make_terminal_node(1);
+    for (int32 level = nodes_.get_leaf_level() - 1; level >= 0; --level)
+    {
+        int32 const index = nodes_.get_index(level);
+        int32 const value = index < cube.size() ? cube.get(index)
+                                                : bool_cube::DontCare;
+        if (value == 0 || value == 1)
+        {
+            son_container sons = nodes_.make_son_container(2);
+            sons[value]        = node;
+            sons[1 - value]    = nodes_.make_terminal_node(0);
+            node               = nodes_.make_internal_node(index, sons);
+        }
+    }
+    return diagram_t(node);
+}
+
+template<class Data, class Degree, class Domain>
+template<expression_node Node>
+auto diagram_manager<Data, Degree, Domain>::from_expression_tree(
+    Node const& root
+) -> diagram_t
+{
+    node_t* newRoot = this->from_expression_tree_impl(root);
+    nodes_.run_deferred();
+    return diagram_t(newRoot);
+}
+
+template<class Data, class Degree, class Domain>
+template<class ExprNode>
+auto diagram_manager<Data, Degree, Domain>::from_expression_tree_impl(
+    ExprNode const& exprNode
+) -> node_t*
+{
+    if (exprNode.is_constant())
+    {
+        return nodes_.make_terminal_node(exprNode.get_value());
+    }
+
+    if (exprNode.is_variable())
+    {
+        return this->variable_impl(exprNode.get_index());
+    }
+
+    assert(exprNode.is_operation());
+
+    node_t* const left  = this->from_expression_tree_impl(exprNode.get_left());
+    node_t* const right = this->from_expression_tree_impl(exprNode.get_right());
+    auto const operation = [&exprNode] (auto const lhs, auto const rhs)
+    {
+        if (lhs == Nondetermined || rhs == Nondetermined)
+        {
+            return Nondetermined;
         }
         return static_cast<int32>(exprNode.evaluate(lhs, rhs));
     };
 
-    node_t* const newRoot = this->apply_n_impl(cache, operation, left, right);
-    auto const cacheCapacity = cache.size();
-    cache.clear();
-    cache.resize(cacheCapacity);
-    return newRoot;
+    // Each operation node is a different operation for the cache.
+    int32 const opId = nodes_.make_operation_id();
+    return this->apply_n_impl(opId, operation, left, right);
 }
 
 template<class Data, class Degree, class Domain>
@@ -1273,10 +1917,11 @@ auto diagram_manager<Data, Degree, Domain>::apply_n(Diagram const&... diagram)
         ops::MAXB<Domain::value>,
         Op>::type;
 
-    // TODO capacity
-    std::vector<node_pack<sizeof...(Diagram)>, node_t*> cache(100'000);
-    node_t* const newRoot
-        = this->apply_n_impl(cache, OpType(), diagram.unsafe_get_root()...);
+    node_t* const newRoot = this->apply_n_impl(
+        OpType::get_id(),
+        OpType(),
+        diagram.unsafe_get_root()...
+    );
     nodes_.run_deferred();
     return diagram_t(newRoot);
 }
@@ -1284,17 +1929,17 @@ auto diagram_manager<Data, Degree, Domain>::apply_n(Diagram const&... diagram)
 template<class Data, class Degree, class Domain>
 template<class Op, class... Node>
 auto diagram_manager<Data, Degree, Domain>::apply_n_impl(
-    std::vector<node_pack<sizeof...(Node)>>& cache,
+    int32 const opId,
     Op operation,
     Node... nodes
 ) -> node_t*
 {
-    std::size_t const hash                = utils::pack_hash(nodes...);
-    std::size_t const cacheIndex          = hash % cache.size();
-    node_pack<sizeof...(Node)>& cachePack = cache[cacheIndex];
-    if (pack_equals(cachePack, nodes...))
+    int32 constexpr OperandCount = static_cast<int32>(sizeof...(Node));
+    node_t* const operands[] {nodes...};
+    node_t* const cached = nodes_.cache_find_n(opId, operands, OperandCount);
+    if (cached)
     {
-        return cachePack.result_;
+        return cached;
     }
 
     int32 const opVal = operation(
@@ -1315,7 +1960,7 @@ auto diagram_manager<Data, Degree, Domain>::apply_n_impl(
         for (int32 k = 0; k < domain; ++k)
         {
             sons[k] = this->apply_n_impl(
-                cache,
+                opId,
                 operation,
                 (nodes_.get_level(nodes) == minLevel ? nodes->get_son(k) : nodes
                 )...
@@ -1324,7 +1969,199 @@ auto diagram_manager<Data, Degree, Domain>::apply_n_impl(
         result = nodes_.make_internal_node(topIndex, sons);
     }
 
-    cachePack = {{nodes...}, result};
+    nodes_.cache_put_n(opId, result, operands, OperandCount);
+    return result;
+}
+
+template<class Data, class Degree, class Domain>
+template<class Foo>
+requires(is_bdd<Degree>)
+auto diagram_manager<Data, Degree, Domain>::ite(
+    diagram_t const& f,
+    diagram_t const& g,
+    diagram_t const& h
+) -> utils::second_t<Foo, diagram_t>
+{
+    node_t* const newRoot = this->multiplex_root(
+        ITE_OP_ID,
+        std::array<node_t*, 3> {
+            f.unsafe_get_root(),
+            h.unsafe_get_root(),
+            g.unsafe_get_root()
+        }
+    );
+    nodes_.run_deferred();
+    return diagram_t(newRoot);
+}
+
+template<class Data, class Degree, class Domain>
+auto diagram_manager<Data, Degree, Domain>::multiplex(
+    diagram_t const& selector,
+    std::vector<diagram_t> const& cases
+) -> diagram_t
+{
+    assert(not cases.empty());
+    std::vector<node_t*> operands;
+    operands.reserve(cases.size() + 1);
+    operands.push_back(selector.unsafe_get_root());
+    for (diagram_t const& diagram : cases)
+    {
+        operands.push_back(diagram.unsafe_get_root());
+    }
+
+    node_t* const newRoot = this->multiplex_root(
+        MULTIPLEX_OP_ID,
+        static_cast<std::vector<node_t*>&&>(operands)
+    );
+    nodes_.run_deferred();
+    return diagram_t(newRoot);
+}
+
+template<class Data, class Degree, class Domain>
+template<class Operands>
+auto diagram_manager<Data, Degree, Domain>::multiplex_root(
+    int32 const opId,
+    Operands operands
+) -> node_t*
+{
+    auto const caseCount = static_cast<int32>(std::ssize(operands)) - 1;
+    node_t* const result
+        = this->multiplex_impl(opId, static_cast<Operands&&>(operands));
+
+    // Constants from the normalization are marked when created and might
+    // not have been used as a son. Marks are released the usual way.
+    for (int32 k = 0; k < caseCount; ++k)
+    {
+        node_t* const constant = nodes_.get_terminal_node(k);
+        if (constant && is_constant_case(k))
+        {
+            static_cast<void>(diagram_t(constant));
+        }
+    }
+    return result;
+}
+
+template<class Data, class Degree, class Domain>
+auto diagram_manager<Data, Degree, Domain>::is_constant_case(
+    [[maybe_unused]] int32 const k
+) -> bool
+{
+    if constexpr (domains::is_fixed<Domain>::value)
+    {
+        return k < Domain::value;
+    }
+    else
+    {
+        return true;
+    }
+}
+
+template<class Data, class Degree, class Domain>
+template<class Operands>
+auto diagram_manager<Data, Degree, Domain>::multiplex_impl(
+    int32 const opId,
+    Operands operands
+) -> node_t*
+{
+    auto const operandCount = static_cast<int32>(std::ssize(operands));
+    int32 const caseCount   = operandCount - 1;
+    node_t* const selector  = operands[0];
+    if (selector->is_terminal())
+    {
+        int32 const value = selector->get_value();
+        assert(value < caseCount || value == Undefined);
+        return value == Undefined ? selector : operands[as_uindex(value + 1)];
+    }
+
+    // Normalization: selector has value k wherever the k-th case is
+    // selected so a case equal to the selector can be the constant k.
+    // Then all-equal cases and the identity are resolved without
+    // recursion, e.g. ite(f, f, h) = ite(f, 1, h) and ite(f, 1, 0) = f.
+    // Both checks are done before any constant is created.
+    auto const is_replaced = [selector, &operands] (int32 const k)
+    {
+        return operands[as_uindex(k + 1)] == selector && is_constant_case(k);
+    };
+    auto const is_value = [] (node_t* const node, int32 const value)
+    {
+        return node->is_terminal() && node->get_value() == value;
+    };
+
+    node_t* const first = operands[1];
+    auto const is_same_as_first
+        = [first, &operands, &is_replaced, &is_value] (int32 const k)
+    {
+        node_t* const option = operands[as_uindex(k + 1)];
+        if (is_replaced(0))
+        {
+            return not is_replaced(k) && is_value(option, 0);
+        }
+        if (is_replaced(k))
+        {
+            return is_value(first, k);
+        }
+        return option == first;
+    };
+
+    bool isSame     = true;
+    bool isIdentity = true;
+    for (int32 k = 0; k < caseCount; ++k)
+    {
+        node_t* const option = operands[as_uindex(k + 1)];
+        isIdentity = isIdentity && (is_replaced(k) || is_value(option, k));
+        isSame     = isSame && (k == 0 || is_same_as_first(k));
+    }
+
+    if (isIdentity)
+    {
+        return selector;
+    }
+
+    if (isSame)
+    {
+        return is_replaced(0) ? nodes_.make_terminal_node(0) : first;
+    }
+
+    for (int32 k = 0; k < caseCount; ++k)
+    {
+        if (is_replaced(k))
+        {
+            operands[as_uindex(k + 1)] = nodes_.make_terminal_node(k);
+        }
+    }
+
+    node_t* const cached
+        = nodes_.cache_find_n(opId, operands.data(), operandCount);
+    if (cached)
+    {
+        return cached;
+    }
+
+    int32 topLevel = nodes_.get_leaf_level();
+    for (node_t* const operand : operands)
+    {
+        topLevel = utils::min(topLevel, nodes_.get_level(operand));
+    }
+
+    int32 const topIndex = nodes_.get_index(topLevel);
+    int32 const domain   = nodes_.get_domain(topIndex);
+    son_container sons   = nodes_.make_son_container(domain);
+    Operands cofactors   = operands;
+    for (int32 k = 0; k < domain; ++k)
+    {
+        for (int32 i = 0; i < operandCount; ++i)
+        {
+            node_t* const operand = operands[as_uindex(i)];
+            cofactors[as_uindex(i)]
+                = nodes_.get_level(operand) == topLevel
+                    ? operand->get_son(k)
+                    : operand;
+        }
+        sons[k] = this->multiplex_impl(opId, cofactors);
+    }
+
+    node_t* const result = nodes_.make_internal_node(topIndex, sons);
+    nodes_.cache_put_n(opId, result, operands.data(), operandCount);
     return result;
 }
 
@@ -1373,115 +2210,622 @@ auto diagram_manager<Data, Degree, Domain>::tree_fold(I first, S const last)
     int64 currentCount    = count;
     auto const numOfSteps = static_cast<int64>(std::ceil(std::log2(count)));
 
-    for (auto step = 0; step < numOfSteps; ++step)
+    for (auto step = 0; step < numOfSteps; ++step)
+    {
+        auto const justMoveLast = static_cast<bool>(currentCount & 1);
+        currentCount            = (currentCount / 2) + justMoveLast;
+        int64 const pairCount   = currentCount - justMoveLast;
+
+        for (int64 i = 0; i < pairCount; ++i)
+        {
+            *(first + i)
+                = this->apply<Op>(*(first + 2 * i), *(first + 2 * i + 1));
+        }
+
+        if (justMoveLast)
+        {
+            *(first + currentCount - 1)
+                = static_cast<diagram_t&&>(*(first + 2 * (currentCount - 1)));
+        }
+    }
+
+    return diagram_t(static_cast<diagram_t&&>(*first));
+}
+
+template<class Data, class Degree, class Domain>
+template<in_var_values Vars>
+auto diagram_manager<Data, Degree, Domain>::evaluate(
+    diagram_t const& diagram,
+    Vars const& values
+) const -> int32
+{
+    node_t* node = diagram.unsafe_get_root();
+
+    while (not node->is_terminal())
+    {
+        int32 const index = node->get_index();
+        assert(nodes_.is_valid_var_value(index, values[as_uindex(index)]));
+        node = node->get_son(values[as_uindex(index)]);
+    }
+
+    return node->get_value();
+}
+
+template<class Data, class Degree, class Domain>
+template<
+    std::ranges::random_access_range Matrix,
+    std::output_iterator<int32> O>
+requires in_var_values<std::ranges::range_value_t<Matrix>>
+auto diagram_manager<Data, Degree, Domain>::evaluate_batch(
+    diagram_t const& diagram,
+    Matrix const& values,
+    O out
+) const -> void
+{
+    int64 constexpr GroupSize = 8;
+    node_t* const root        = diagram.unsafe_get_root();
+    auto const first          = std::ranges::begin(values);
+    auto const totalCount     = static_cast<int64>(std::ranges::size(values));
+
+    for (int64 groupFirst = 0; groupFirst < totalCount; groupFirst += GroupSize)
+    {
+        int64 const groupSize = utils::min(GroupSize, totalCount - groupFirst);
+        node_t* nodes[GroupSize];
+        for (int64 i = 0; i < groupSize; ++i)
+        {
+            nodes[i] = root;
+        }
+
+        // Moves each traversal one level down per round. Loads of sons
+        // are independent so they can be in flight at the same time.
+        bool isDone = false;
+        while (not isDone)
+        {
+            isDone = true;
+            for (int64 i = 0; i < groupSize; ++i)
+            {
+                node_t* const node = nodes[i];
+                if (node->is_terminal())
+                {
+                    continue;
+                }
+
+                auto const& vars  = first[groupFirst + i];
+                int32 const index = node->get_index();
+                int32 const value = static_cast<int32>(vars[as_uindex(index)]);
+                assert(nodes_.is_valid_var_value(index, value));
+                node_t* const son = node->get_son(value);
+                utils::prefetch(son);
+                nodes[i] = son;
+                isDone   = false;
+            }
+        }
+
+        for (int64 i = 0; i < groupSize; ++i)
+        {
+            *out = nodes[i]->get_value();
+            ++out;
+        }
+    }
+}
+
+template<class Data, class Degree, class Domain>
+auto diagram_manager<Data, Degree, Domain>::make_image(
+    diagram_t const& diagram
+) const -> diagram_image
+{
+    // Level order traversal puts sons after their parents.
+    std::vector<node_t*> order;
+    nodes_.traverse_level(
+        diagram.unsafe_get_root(),
+        [&order] (node_t* const node)
+        {
+            // Offset of the node must fit into the scratch.
+            assert(order.size() < as_usize(std::numeric_limits<int32>::max()));
+            node->set_scratch(static_cast<int32>(order.size()));
+            order.push_back(node);
+        }
+    );
+
+    std::vector<diagram_image::entry> imageNodes;
+    std::vector<uint32> sons;
+    imageNodes.reserve(order.size());
+    for (node_t* const node : order)
+    {
+        if (node->is_terminal())
+        {
+            imageNodes.push_back(diagram_image::entry {
+                diagram_image::TerminalIndex,
+                static_cast<uint32>(node->get_value())
+            });
+            continue;
+        }
+
+        int32 const nodeDomain = nodes_.get_domain(node);
+        assert(
+            sons.size() + as_usize(nodeDomain)
+            <= std::numeric_limits<uint32>::max()
+        );
+        imageNodes.push_back(diagram_image::entry {
+            node->get_index(),
+            static_cast<uint32>(sons.size())
+        });
+        for (int32 k = 0; k < nodeDomain; ++k)
+        {
+            node_t* const son = node->get_son(k);
+            sons.push_back(static_cast<uint32>(son->get_scratch()));
+        }
+    }
+
+    int32 const varCount = this->get_var_count();
+    std::vector<int32> levels(as_usize(varCount));
+    for (int32 index = 0; index < varCount; ++index)
+    {
+        levels[as_uindex(index)] = nodes_.get_level(index);
+    }
+
+    return diagram_image(
+        this->get_domains(),
+        static_cast<std::vector<int32>&&>(levels),
+        static_cast<std::vector<diagram_image::entry>&&>(imageNodes),
+        static_cast<std::vector<uint32>&&>(sons)
+    );
+}
+
+template<class Data, class Degree, class Domain>
+auto diagram_manager<Data, Degree, Domain>::save(
+    std::vector<diagram_t> const& diagrams,
+    std::ostream& out
+) const -> void
+{
+    std::vector<node_t*> roots;
+    roots.reserve(diagrams.size());
+    for (diagram_t const& diagram : diagrams)
+    {
+        roots.push_back(diagram.unsafe_get_root());
+    }
+
+    // Nodes are grouped by levels from the bottom so that sons always
+    // precede their parents and the index is stored once per level.
+    int32 const leafLevel = nodes_.get_leaf_level();
+    std::vector<std::vector<node_t*>> levels(as_usize(leafLevel + 1));
+    nodes_.traverse_post_numbered(
+        roots,
+        [this, &levels] (node_t* const node)
+        { levels[as_uindex(nodes_.get_level(node))].push_back(node); }
+    );
+
+    int32 nextId = 0;
+    for (int32 level = leafLevel; level >= 0; --level)
+    {
+        for (node_t* const node : levels[as_uindex(level)])
+        {
+            node->set_scratch(nextId);
+            ++nextId;
+        }
+    }
+
+    out.write(BINARY_MAGIC.data(), std::ssize(BINARY_MAGIC));
+    utils::write_varint(out, BINARY_VERSION);
+    utils::write_varint(out, static_cast<uint64>(leafLevel));
+    for (int32 const domain : this->get_domains())
+    {
+        utils::write_varint(out, static_cast<uint64>(domain));
+    }
+    for (int32 const index : this->get_order())
+    {
+        utils::write_varint(out, static_cast<uint64>(index));
+    }
+
+    std::vector<node_t*> const& terminals = levels[as_uindex(leafLevel)];
+    utils::write_varint(out, terminals.size());
+    for (node_t* const terminal : terminals)
+    {
+        utils::write_varint(out, static_cast<uint64>(terminal->get_value()));
+    }
+
+    for (int32 level = leafLevel - 1; level >= 0; --level)
+    {
+        std::vector<node_t*> const& levelNodes = levels[as_uindex(level)];
+        utils::write_varint(out, levelNodes.size());
+        for (node_t* const node : levelNodes)
+        {
+            int32 const nodeId     = node->get_scratch();
+            int32 const nodeDomain = nodes_.get_domain(node);
+            for (int32 k = 0; k < nodeDomain; ++k)
+            {
+                int32 const sonId = node->get_son(k)->get_scratch();
+                utils::write_varint(out, static_cast<uint64>(nodeId - sonId));
+            }
+        }
+    }
+
+    utils::write_varint(out, roots.size());
+    for (node_t* const root : roots)
+    {
+        utils::write_varint(out, static_cast<uint64>(root->get_scratch()));
+    }
+}
+
+template<class Data, class Degree, class Domain>
+auto diagram_manager<Data, Degree, Domain>::load(std::istream& in)
+    -> std::optional<std::vector<diagram_t>>
+{
+    char magic[BINARY_MAGIC.size()] {};
+    in.read(magic, std::ssize(BINARY_MAGIC));
+    if (not in || std::string_view(magic, BINARY_MAGIC.size()) != BINARY_MAGIC)
+    {
+        return std::nullopt;
+    }
+
+    auto const read = [&in] () { return utils::read_varint(in); };
+    if (read() != BINARY_VERSION)
+    {
+        return std::nullopt;
+    }
+
+    int32 const leafLevel = nodes_.get_leaf_level();
+    if (read() != static_cast<uint64>(leafLevel))
+    {
+        return std::nullopt;
+    }
+    for (int32 const domain : this->get_domains())
+    {
+        if (read() != static_cast<uint64>(domain))
+        {
+            return std::nullopt;
+        }
+    }
+    for (int32 const index : this->get_order())
+    {
+        if (read() != static_cast<uint64>(index))
+        {
+            return std::nullopt;
+        }
+    }
+
+    // Loaded nodes stay marked until they become sons of other nodes
+    // or roots of diagrams so that the GC does not collect them.
+    // If the input is invalid, they are released as garbage.
+    std::vector<node_t*> loaded;
+    auto const fail = [&loaded] () -> std::optional<std::vector<diagram_t>>
+    {
+        for (node_t* const node : loaded)
+        {
+            static_cast<void>(diagram_t(node));
+        }
+        return std::nullopt;
+    };
+
+    std::optional<uint64> const terminalCount = read();
+    if (not terminalCount)
     {
-        auto const justMoveLast = static_cast<bool>(currentCount & 1);
-        currentCount            = (currentCount / 2) + justMoveLast;
-        int64 const pairCount   = currentCount - justMoveLast;
+        return fail();
+    }
+    for (uint64 i = 0; i < *terminalCount; ++i)
+    {
+        std::optional<uint64> const value = read();
+        bool isValid = value && *value <= static_cast<uint64>(Undefined);
+        if constexpr (domains::is_fixed<Domain>::value)
+        {
+            isValid = isValid
+                   && (*value < Domain::value
+                       || *value == static_cast<uint64>(Undefined));
+        }
+        if (not isValid)
+        {
+            return fail();
+        }
+        loaded.push_back(nodes_.make_terminal_node(static_cast<int32>(*value))
+        );
+    }
 
-        for (int64 i = 0; i < pairCount; ++i)
+    std::vector<node_t*> sonNodes;
+    for (int32 level = leafLevel - 1; level >= 0; --level)
+    {
+        std::optional<uint64> const nodeCount = read();
+        if (not nodeCount)
         {
-            *(first + i)
-                = this->apply<Op>(*(first + 2 * i), *(first + 2 * i + 1));
+            return fail();
         }
 
-        if (justMoveLast)
+        // Sons must be on one of the levels below.
+        int32 const index       = nodes_.get_index(level);
+        int32 const domain      = nodes_.get_domain(index);
+        uint64 const levelFirst = loaded.size();
+        for (uint64 i = 0; i < *nodeCount; ++i)
         {
-            *(first + currentCount - 1)
-                = static_cast<diagram_t&&>(*(first + 2 * (currentCount - 1)));
+            uint64 const nodeId = loaded.size();
+            sonNodes.clear();
+            for (int32 k = 0; k < domain; ++k)
+            {
+                std::optional<uint64> const distance = read();
+                if (not distance || *distance > nodeId
+                    || nodeId - *distance >= levelFirst)
+                {
+                    return fail();
+                }
+                sonNodes.push_back(loaded[nodeId - *distance]);
+            }
+
+            son_container sons = nodes_.make_son_container(domain);
+            for (int32 k = 0; k < domain; ++k)
+            {
+                sons[k] = sonNodes[as_uindex(k)];
+            }
+            loaded.push_back(nodes_.make_internal_node(index, sons));
         }
     }
 
-    return diagram_t(static_cast<diagram_t&&>(*first));
-}
+    std::optional<uint64> const rootCount = read();
+    if (not rootCount)
+    {
+        return fail();
+    }
+    std::vector<node_t*> roots;
+    for (uint64 i = 0; i < *rootCount; ++i)
+    {
+        std::optional<uint64> const rootId = read();
+        if (not rootId || *rootId >= loaded.size())
+        {
+            return fail();
+        }
+        roots.push_back(loaded[*rootId]);
+    }
 
-template<class Data, class Degree, class Domain>
-template<in_var_values Vars>
-auto diagram_manager<Data, Degree, Domain>::evaluate(
-    diagram_t const& diagram,
-    Vars const& values
-) const -> int32
-{
-    node_t* node = diagram.unsafe_get_root();
+    std::vector<diagram_t> diagrams;
+    diagrams.reserve(roots.size());
+    for (node_t* const root : roots)
+    {
+        diagrams.emplace_back(root);
+    }
 
-    while (not node->is_terminal())
+    // Nodes that are neither sons nor roots would stay marked forever.
+    for (node_t* const node : loaded)
     {
-        int32 const index = node->get_index();
-        assert(nodes_.is_valid_var_value(index, values[as_uindex(index)]));
-        node = node->get_son(values[as_uindex(index)]);
+        if (node->is_marked())
+        {
+            static_cast<void>(diagram_t(node));
+        }
     }
+    nodes_.run_deferred();
 
-    return node->get_value();
+    return std::optional<std::vector<diagram_t>>(
+        static_cast<std::vector<diagram_t>&&>(diagrams)
+    );
 }
 
 template<class Data, class Degree, class Domain>
+template<class Int>
 auto diagram_manager<Data, Degree, Domain>::satisfy_count(
     int32 const value,
     diagram_t const& diagram
-) -> int64
+) -> Int
 {
     if constexpr (domains::is_fixed<Domain>::value)
     {
         assert(value < Domain::value);
     }
 
-    auto constexpr CanUseDataMember = not utils::is_void<Data>::value;
-    using T = utils::type_if<CanUseDataMember, Data, int64>::type;
-
-    // A function that returns reference to
-    // the data associated with given node.
-    auto data = [] ()
+    // Counts are stored in a dense array of slots. Traversal gives nodes
+    // consecutive ids in post-order so the id of a node is the index of
+    // the next free slot. int64 counts reuse buffer of the node manager.
+    std::vector<Int> ownSlots;
+    std::vector<Int>& slots = [this, &ownSlots] () -> std::vector<Int>&
     {
-        if constexpr (CanUseDataMember)
+        if constexpr (utils::is_same<Int, int64>::value)
         {
-            // Simply return reference to the data member.
-            return [] (node_t* const node) mutable -> T&
-            { return (node->get_data()); };
+            return nodes_.get_scratch_buffer();
         }
         else
         {
-            // Return reference to the data that is stored in the map.
-            return [map = std::unordered_map<node_t*, T>()] (node_t* const node
-                   ) mutable -> T&
-            {
-                // If there is no value for given key [] creates new pair
-                // and value-initializes the value (0 for primitive types).
-                return map[node];
-            };
+            return ownSlots;
         }
     }();
 
     node_t* const root = diagram.unsafe_get_root();
 
     // Actual satisfy count algorithm.
-    nodes_.traverse_post(
+    nodes_.traverse_post_numbered(
         root,
-        [this, value, &data] (node_t* const node) mutable
+        [this, value, &slots] (node_t* const node)
         {
             if (node->is_terminal())
             {
-                data(node) = node->get_value() == value ? 1 : 0;
+                slots.emplace_back(node->get_value() == value ? 1 : 0);
             }
             else
             {
-                data(node)             = 0;
+                Int count              = 0;
                 int32 const nodeLevel  = nodes_.get_level(node);
                 int32 const nodeDomain = nodes_.get_domain(node);
                 for (int32 k = 0; k < nodeDomain; ++k)
                 {
                     node_t* const son    = node->get_son(k);
                     int32 const sonLevel = nodes_.get_level(son);
-                    int64 const diff
-                        = nodes_.domain_product(nodeLevel + 1, sonLevel);
-                    data(node) += data(son) * static_cast<T>(diff);
+                    count
+                        += slots[as_uindex(son->get_scratch())]
+                         * this->template domain_product_as<Int>(
+                               nodeLevel + 1,
+                               sonLevel
+                         );
                 }
+                slots.push_back(count);
             }
         }
     );
 
-    auto const rootAlpha  = static_cast<int64>(data(root));
     int32 const rootLevel = nodes_.get_level(root);
-    return rootAlpha * nodes_.domain_product(0, rootLevel);
+    return slots.back() * this->template domain_product_as<Int>(0, rootLevel);
+}
+
+template<class Data, class Degree, class Domain>
+template<class Int>
+auto diagram_manager<Data, Degree, Domain>::satisfy_counts(
+    diagram_t const& diagram
+) -> std::vector<Int>
+{
+    node_t* const root    = diagram.unsafe_get_root();
+    int32 const rootLevel = nodes_.get_level(root);
+
+    std::vector<Int> counts = this->template terminal_weights<Int>(
+        root,
+        [this] (node_t* const node, node_t* const son, int32)
+        {
+            return this->template domain_product_as<Int>(
+                nodes_.get_level(node) + 1,
+                nodes_.get_level(son)
+            );
+        }
+    );
+    Int const rootProduct = this->template domain_product_as<Int>(0, rootLevel);
+    for (Int& count : counts)
+    {
+        count = count * rootProduct;
+    }
+    return counts;
+}
+
+template<class Data, class Degree, class Domain>
+template<class T, class EdgeWeight>
+auto diagram_manager<Data, Degree, Domain>::terminal_weights(
+    node_t* const root,
+    EdgeWeight edgeWeight
+) -> std::vector<T>
+{
+    std::vector<std::vector<T>> weights = this->template terminal_weights<T>(
+        std::vector<node_t*> {root},
+        static_cast<EdgeWeight&&>(edgeWeight)
+    );
+    return static_cast<std::vector<T>&&>(weights.front());
+}
+
+template<class Data, class Degree, class Domain>
+template<class T, class EdgeWeight>
+auto diagram_manager<Data, Degree, Domain>::terminal_weights(
+    std::vector<node_t*> const& roots,
+    EdgeWeight edgeWeight
+) -> std::vector<std::vector<T>>
+{
+    // Stride of the array. Constant for fixed domains so that loops
+    // over accumulators have fixed trip count and can be vectorized.
+    int32 const valueCount = this->get_value_count();
+    auto const stride      = [valueCount] ()
+    {
+        if constexpr (domains::is_fixed<Domain>::value)
+        {
+            return std::size_t {Domain::value};
+        }
+        else
+        {
+            return as_usize(valueCount);
+        }
+    }();
+
+    // int64 accumulators reuse buffer of the node manager.
+    std::vector<T> ownAccumulators;
+    std::vector<T>& accumulators
+        = [this, &ownAccumulators] () -> std::vector<T>&
+    {
+        if constexpr (utils::is_same<T, int64>::value)
+        {
+            return nodes_.get_scratch_buffer();
+        }
+        else
+        {
+            return ownAccumulators;
+        }
+    }();
+
+    nodes_.traverse_post_numbered(
+        roots,
+        [this, &accumulators, &edgeWeight, stride] (node_t* const node)
+        {
+            std::size_t const base = accumulators.size();
+            accumulators.resize(base + stride, T(0));
+            if (node->is_terminal())
+            {
+                auto const value = as_usize(node->get_value());
+                if (value < stride)
+                {
+                    accumulators[base + value] = T(1);
+                }
+                return;
+            }
+
+            int32 const nodeDomain = nodes_.get_domain(node);
+            for (int32 k = 0; k < nodeDomain; ++k)
+            {
+                node_t* const son = node->get_son(k);
+                T const weight    = edgeWeight(node, son, k);
+                std::size_t const sonBase
+                    = as_usize(son->get_scratch()) * stride;
+                for (std::size_t i = 0; i < stride; ++i)
+                {
+                    accumulators[base + i]
+                        += weight * accumulators[sonBase + i];
+                }
+            }
+        }
+    );
+
+    std::vector<std::vector<T>> weights;
+    weights.reserve(roots.size());
+    for (node_t* const root : roots)
+    {
+        std::size_t const rootBase = as_usize(root->get_scratch()) * stride;
+        weights.emplace_back(
+            accumulators.begin() + static_cast<std::ptrdiff_t>(rootBase),
+            accumulators.begin()
+                + static_cast<std::ptrdiff_t>(rootBase + stride)
+        );
+    }
+    return weights;
+}
+
+template<class Data, class Degree, class Domain>
+auto diagram_manager<Data, Degree, Domain>::get_value_count() const -> int32
+{
+    if constexpr (domains::is_fixed<Domain>::value)
+    {
+        return Domain::value;
+    }
+    else
+    {
+        int32 valueCount = 0;
+        nodes_.for_each_terminal_node(
+            [&valueCount] (node_t* const node)
+            { valueCount = utils::max(valueCount, node->get_value() + 1); }
+        );
+        return valueCount;
+    }
+}
+
+template<class Data, class Degree, class Domain>
+template<class Int>
+auto diagram_manager<Data, Degree, Domain>::domain_product_as(
+    int32 const levelFrom,
+    int32 const levelTo
+) const -> Int
+{
+    if constexpr (utils::is_same<Int, int64>::value)
+    {
+        return nodes_.domain_product(levelFrom, levelTo);
+    }
+    else if constexpr (domains::is_fixed<Domain>::value)
+    {
+        return utils::int_pow(Int(Domain::value), levelTo - levelFrom);
+    }
+    else
+    {
+        Int product = 1;
+        for (int32 level = levelFrom; level < levelTo; ++level)
+        {
+            int32 const index = nodes_.get_index(level);
+            product           = product * Int(nodes_.get_domain(index));
+        }
+        return product;
+    }
 }
 
 template<class Data, class Degree, class Domain>
@@ -1570,6 +2914,220 @@ auto diagram_manager<Data, Degree, Domain>::satisfy_all_g(
     this->satisfy_all_impl(value, vars, out, root, 0);
 }
 
+template<class Data, class Degree, class Domain>
+auto diagram_manager<Data, Degree, Domain>::satisfy_range(
+    int32 const value,
+    diagram_t const& diagram,
+    satisfy_mode const mode
+) const -> satisfying_range<Data, Degree, Domain>
+{
+    if constexpr (domains::is_fixed<Domain>::value)
+    {
+        assert(value < Domain::value);
+    }
+
+    return satisfying_range<Data, Degree, Domain>(
+        &nodes_,
+        diagram.unsafe_get_root(),
+        value,
+        mode
+    );
+}
+
+template<class Data, class Degree, class Domain>
+template<class Rng>
+auto diagram_manager<Data, Degree, Domain>::sample_satisfying(
+    int32 const value,
+    diagram_t const& diagram,
+    Rng& rng,
+    int64 const count
+) -> std::vector<std::vector<int32>>
+{
+    if constexpr (domains::is_fixed<Domain>::value)
+    {
+        assert(value < Domain::value);
+    }
+
+    // Uniform distribution of variable values gives uniform distribution
+    // of assignments. Probabilities, unlike counts, do not overflow
+    // and sample_satisfying_impl keeps them from underflowing.
+    return this->sample_satisfying_impl(
+        value,
+        diagram.unsafe_get_root(),
+        rng,
+        count,
+        [this] (int32 const index, int32)
+        { return 1.0 / static_cast<double>(nodes_.get_domain(index)); }
+    );
+}
+
+template<class Data, class Degree, class Domain>
+template<class Rng, class VarProb>
+auto diagram_manager<Data, Degree, Domain>::sample_satisfying_impl(
+    int32 const value,
+    node_t* const root,
+    Rng& rng,
+    int64 const count,
+    VarProb varProb
+) -> std::vector<std::vector<int32>>
+{
+    // Probability that a random path from a node ends in the terminal
+    // with the given value. It is a product of as many probabilities
+    // as there are levels so it would underflow in a plain double.
+    // Each weight is kept as mantissa * 2^exponent and sons are only
+    // ever compared relative to their parent. Nodes are numbered the
+    // same way as in satisfy_count so that the slot of a node is its
+    // scratch id.
+    struct scaled_weight
+    {
+        double mantissa_;
+        int64 exponent_;
+    };
+
+    auto const make_weight = [] (double const mantissa, int64 const exponent)
+    {
+        int shift           = 0;
+        double const scaled = std::frexp(mantissa, &shift);
+        return scaled_weight {
+            scaled,
+            scaled == 0.0 ? 0 : exponent + shift};
+    };
+
+    // Weight relative to 2^exponent, far smaller weights become 0.
+    auto const relative = [] (scaled_weight const& weight, int64 exponent)
+    {
+        int64 const shift = utils::min(
+            utils::max(weight.exponent_ - exponent, int64 {-2'000}),
+            int64 {2'000}
+        );
+        return std::ldexp(weight.mantissa_, static_cast<int>(shift));
+    };
+
+    std::vector<scaled_weight> weights;
+    nodes_.traverse_post_numbered(
+        root,
+        [this, value, &weights, &varProb, &make_weight, &relative] (
+            node_t* const node
+        )
+        {
+            if (node->is_terminal())
+            {
+                weights.push_back(
+                    make_weight(node->get_value() == value ? 1.0 : 0.0, 0)
+                );
+                return;
+            }
+
+            int32 const nodeIndex  = node->get_index();
+            int32 const nodeDomain = nodes_.get_domain(nodeIndex);
+            int64 topExponent      = std::numeric_limits<int64>::min();
+            for (int32 k = 0; k < nodeDomain; ++k)
+            {
+                scaled_weight const& sonWeight
+                    = weights[as_uindex(node->get_son(k)->get_scratch())];
+                if (sonWeight.mantissa_ > 0.0)
+                {
+                    topExponent
+                        = utils::max(topExponent, sonWeight.exponent_);
+                }
+            }
+
+            double sum = 0.0;
+            for (int32 k = 0; k < nodeDomain; ++k)
+            {
+                scaled_weight const& sonWeight
+                    = weights[as_uindex(node->get_son(k)->get_scratch())];
+                if (sonWeight.mantissa_ > 0.0)
+                {
+                    sum += varProb(nodeIndex, k)
+                         * relative(sonWeight, topExponent);
+                }
+            }
+            weights.push_back(make_weight(sum, sum > 0.0 ? topExponent : 0));
+        }
+    );
+
+    std::vector<std::vector<int32>> samples;
+    if (weights[as_uindex(root->get_scratch())].mantissa_ <= 0.0)
+    {
+        return samples;
+    }
+
+    // Chooses value of a variable with probability proportional to
+    // the probability of the value times the weight of the edge.
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    auto const draw = [this, &rng, &uniform, &varProb] (
+                          int32 const index,
+                          auto const& edgeWeight
+                      )
+    {
+        int32 const domain = nodes_.get_domain(index);
+        double total       = 0.0;
+        for (int32 k = 0; k < domain; ++k)
+        {
+            total += varProb(index, k) * edgeWeight(k);
+        }
+
+        double target = uniform(rng) * total;
+        int32 chosen  = 0;
+        for (int32 k = 0; k < domain; ++k)
+        {
+            double const weight = varProb(index, k) * edgeWeight(k);
+            if (weight > 0.0)
+            {
+                // Last positive candidate absorbs rounding errors.
+                chosen = k;
+                if (target < weight)
+                {
+                    break;
+                }
+                target -= weight;
+            }
+        }
+        return chosen;
+    };
+
+    int32 const leafLevel = nodes_.get_leaf_level();
+    samples.reserve(as_usize(count));
+    for (int64 i = 0; i < count; ++i)
+    {
+        std::vector<int32> vars(as_usize(this->get_var_count()));
+        node_t* node = root;
+        for (int32 level = 0; level < leafLevel; ++level)
+        {
+            int32 const index = nodes_.get_index(level);
+            if (nodes_.get_level(node) > level)
+            {
+                // Variable was skipped, any of its values is fine.
+                vars[as_uindex(index)]
+                    = draw(index, [] (int32) { return 1.0; });
+            }
+            else
+            {
+                int64 const exponent
+                    = weights[as_uindex(node->get_scratch())].exponent_;
+                int32 const k = draw(
+                    index,
+                    [node, exponent, &weights, &relative] (
+                        int32 const sonIndex
+                    )
+                    {
+                        node_t* const son = node->get_son(sonIndex);
+                        return relative(
+                            weights[as_uindex(son->get_scratch())],
+                            exponent
+                        );
+                    }
+                );
+                vars[as_uindex(index)] = k;
+                node                   = node->get_son(k);
+            }
+        }
+        samples.push_back(static_cast<std::vector<int32>&&>(vars));
+    }
+    return samples;
+}
+
 template<class Data, class Degree, class Domain>
 template<class Vars, class OutputIt>
 auto diagram_manager<Data, Degree, Domain>::satisfy_all_impl(
@@ -1632,9 +3190,8 @@ auto diagram_manager<Data, Degree, Domain>::get_cofactor(
         return diagram_t(root->get_son(varValue));
     }
 
-    std::unordered_map<node_t*, node_t*> memo;
     diagram_t result
-        = diagram_t(this->get_cofactor_impl(memo, varIndex, varValue, root));
+        = diagram_t(this->get_cofactor_impl(varIndex, varValue, root));
     nodes_.run_deferred();
     return result;
 }
@@ -1664,31 +3221,20 @@ auto diagram_manager<Data, Degree, Domain>::get_cofactor(
         --toCofactor;
     }
 
-    std::unordered_map<node_t*, node_t*> memo;
-    diagram_t result = diagram_t(this->get_cofactor_impl(
-        memo,
-        vars,
-        root,
-        toCofactor
-    ));
+    int32 const opId = nodes_.make_operation_id();
+    diagram_t result
+        = diagram_t(this->get_cofactor_impl(opId, vars, root, toCofactor));
     nodes_.run_deferred();
     return result;
 }
 
 template<class Data, class Degree, class Domain>
 auto diagram_manager<Data, Degree, Domain>::get_cofactor_impl(
-    std::unordered_map<node_t*, node_t*>& memo,
     int32 const varIndex,
     int32 const varValue,
     node_t* const node
 ) -> node_t*
 {
-    auto const memoIt = memo.find(node);
-    if (memoIt != memo.end())
-    {
-        return memoIt->second;
-    }
-
     if (node->is_terminal())
     {
         return node;
@@ -1700,41 +3246,56 @@ auto diagram_manager<Data, Degree, Domain>::get_cofactor_impl(
         return node->get_son(varValue);
     }
 
+    node_t* const cached = nodes_.computed_find(
+        COFACTOR_OP_ID,
+        node,
+        nullptr,
+        varIndex,
+        varValue
+    );
+    if (cached)
+    {
+        return cached;
+    }
+
     int32 const nodeDomain = nodes_.get_domain(node);
     son_container sons     = nodes_.make_son_container(nodeDomain);
     for (int32 k = 0; k < nodeDomain; ++k)
     {
         node_t* const oldSon = node->get_son(k);
-        sons[k] = this->get_cofactor_impl(memo, varIndex, varValue, oldSon);
+        sons[k] = this->get_cofactor_impl(varIndex, varValue, oldSon);
     }
 
     node_t* const newNode = nodes_.make_internal_node(nodeIndex, sons);
-    memo.emplace(node, newNode);
+    nodes_.computed_put(
+        COFACTOR_OP_ID,
+        newNode,
+        node,
+        nullptr,
+        varIndex,
+        varValue
+    );
     return newNode;
 }
 
 template<class Data, class Degree, class Domain>
 auto diagram_manager<Data, Degree, Domain>::get_cofactor_impl(
-    std::unordered_map<node_t*, node_t*>& memo,
+    int32 const opId,
     std::vector<var_cofactor> const& vars,
     node_t* const node,
     int32 const toCofactor
 ) -> node_t*
 {
-    if (toCofactor == 0)
+    if (toCofactor == 0 || node->is_terminal())
     {
         return node;
     }
 
-    auto const memoIt = memo.find(node);
-    if (memoIt != memo.end())
-    {
-        return memoIt->second;
-    }
-
-    if (node->is_terminal())
+    node_t* const cached
+        = nodes_.computed_find(opId, node, nullptr, toCofactor, 0);
+    if (cached)
     {
-        return node;
+        return cached;
     }
 
     int32 const nodeIndex = node->get_index();
@@ -1748,7 +3309,7 @@ auto diagram_manager<Data, Degree, Domain>::get_cofactor_impl(
     if (it != vars.end())
     {
         newNode = this->get_cofactor_impl(
-            memo,
+            opId,
             vars,
             node->get_son(it->value_),
             toCofactor - 1
@@ -1761,12 +3322,12 @@ auto diagram_manager<Data, Degree, Domain>::get_cofactor_impl(
         for (int32 k = 0; k < nodeDomain; ++k)
         {
             node_t* const oldSon = node->get_son(k);
-            sons[k] = this->get_cofactor_impl(memo, vars, oldSon, toCofactor);
+            sons[k] = this->get_cofactor_impl(opId, vars, oldSon, toCofactor);
         }
         newNode = nodes_.make_internal_node(nodeIndex, sons);
     }
 
-    memo.emplace(node, newNode);
+    nodes_.computed_put(opId, newNode, node, nullptr, toCofactor, 0);
     return newNode;
 }
 
@@ -1777,9 +3338,9 @@ auto diagram_manager<Data, Degree, Domain>::transform(
     F transformer
 ) -> diagram_t
 {
-    std::unordered_map<node_t*, node_t*> memo;
+    int32 const opId = nodes_.make_operation_id();
     node_t* const newRoot
-        = this->transform_impl(memo, transformer, diagram.unsafe_get_root());
+        = this->transform_impl(opId, transformer, diagram.unsafe_get_root());
     nodes_.run_deferred();
     return diagram_t(newRoot);
 }
@@ -1787,33 +3348,33 @@ auto diagram_manager<Data, Degree, Domain>::transform(
 template<class Data, class Degree, class Domain>
 template<class F>
 auto diagram_manager<Data, Degree, Domain>::transform_impl(
-    std::unordered_map<node_t*, node_t*>& memo,
+    int32 const opId,
     F transformer,
     node_t* node
 ) -> node_t*
 {
-    auto const memoIt = memo.find(node);
-    if (memo.end() != memoIt)
-    {
-        return memoIt->second;
-    }
-
     if (node->is_terminal())
     {
         int32 const newVal = static_cast<int32>(transformer(node->get_value()));
         return nodes_.make_terminal_node(newVal);
     }
 
+    node_t* const cached = nodes_.computed_find(opId, node, nullptr, 0, 0);
+    if (cached)
+    {
+        return cached;
+    }
+
     int32 const index  = node->get_index();
     int32 const domain = nodes_.get_domain(index);
     son_container sons = nodes_.make_son_container(domain);
     for (int32 k = 0; k < domain; ++k)
     {
         node_t* const son = node->get_son(k);
-        sons[k]           = this->transform_impl(memo, transformer, son);
+        sons[k]           = this->transform_impl(opId, transformer, son);
     }
     node_t* const newNode = nodes_.make_internal_node(index, sons);
-    memo.emplace(node, newNode);
+    nodes_.computed_put(opId, newNode, node, nullptr, 0, 0);
     return newNode;
 }
 
@@ -1823,10 +3384,13 @@ requires(is_bdd<Degree>)
 auto diagram_manager<Data, Degree, Domain>::negate(diagram_t const& diagram)
     -> utils::second_t<Foo, diagram_t>
 {
-    return this->transform(
-        diagram,
-        [] (int32 const value) { return 1 - value; }
+    node_t* const newRoot = this->transform_impl(
+        NEGATE_OP_ID,
+        [] (int32 const value) { return 1 - value; },
+        diagram.unsafe_get_root()
     );
+    nodes_.run_deferred();
+    return diagram_t(newRoot);
 }
 
 template<class Data, class Degree, class Domain>
@@ -1835,7 +3399,7 @@ auto diagram_manager<Data, Degree, Domain>::get_dependency_set(
 ) const -> std::vector<int32>
 {
     std::vector<int32> indices;
-    indices.reserve(this->get_var_count());
+    indices.reserve(as_usize(this->get_var_count()));
     this->get_dependency_set_g(diagram, std::back_inserter(indices));
     indices.shrink_to_fit();
     return indices;
@@ -1851,7 +3415,7 @@ auto diagram_manager<Data, Degree, Domain>::get_dependency_set_g(
     std::vector<bool> memo(as_usize(this->get_var_count()), false);
     nodes_.traverse_pre(
         diagram.unsafe_get_root(),
-        [&memo, out] (node_t* const node) mutable
+        [&memo, &out] (node_t* const node)
         {
             if (node->is_internal())
             {
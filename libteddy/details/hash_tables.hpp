@@ -335,6 +335,209 @@ private:
     cache_entry* entries_;
 };
 
+/**
+ *  \brief Cache for results of operations with any number of operands.
+ *
+ *  Each entry has space for the result and \c arity operands. Unused
+ *  operand slots are nullptr. Arity grows when an operation with more
+ *  operands is stored.
+ */
+template<class Data, class Degree>
+class nary_apply_cache
+{
+public:
+    using node_t = node<Data, Degree>;
+
+public:
+    nary_apply_cache(int64 capacity);
+    nary_apply_cache(nary_apply_cache&& other) noexcept;
+    ~nary_apply_cache();
+
+    nary_apply_cache(nary_apply_cache const&) = delete;
+    auto operator= (nary_apply_cache const&)  = delete;
+    auto operator= (nary_apply_cache&&)       = delete;
+
+public:
+    /**
+     *  \brief Looks up result of an operation
+     *  \param opId id of the operation
+     *  \param operands pointer to the first operand
+     *  \param operandCount number of operands
+     *  \result result of the previous operation or nullptr
+     */
+    auto find (int32 opId, node_t* const* operands, int32 operandCount)
+        -> node_t*;
+
+    /**
+     *  \brief Puts the result into the cache possibly overwriting old value
+     *  \param opId id of the operation
+     *  \param result result
+     *  \param operands pointer to the first operand
+     *  \param operandCount number of operands
+     */
+    auto put (
+        int32 opId,
+        node_t* result,
+        node_t* const* operands,
+        int32 operandCount
+    ) -> void;
+
+    /**
+     *  \brief Increases the capacity so that it is close to \p aproxCapacity
+     *  Never lowers the capacity!
+     *  \param aproxCapacity new capacity
+     */
+    auto grow_capacity (int64 aproxCapacity) -> void;
+
+    /**
+     *  \brief Removes entries pointing to unused nodes
+     */
+    auto remove_unused () -> void;
+
+    /**
+     *  \brief Clears all entries
+     */
+    auto clear () -> void;
+
+private:
+    /**
+     *  \return Current load factor
+     */
+    [[nodiscard]] auto get_load_factor () const -> double;
+
+    /**
+     *  \return Pointer to the first slot of the entry at \p index
+     */
+    [[nodiscard]] auto get_entry (std::size_t index) const -> node_t**;
+
+    /**
+     *  \return Index of the entry for given key
+     */
+    [[nodiscard]] auto get_index (
+        int32 opId,
+        node_t* const* operands,
+        int32 operandCount
+    ) const -> std::size_t;
+
+    /**
+     *  \brief Adjusts capacity and arity of the table
+     *  \param newCapacity New capacity
+     *  \param newArity New arity
+     */
+    auto rehash (int64 newCapacity, int32 newArity) -> void;
+
+private:
+    int64 size_;
+    int64 capacity_;
+    int32 arity_;
+    int32* opIds_;
+    node_t** entries_;
+};
+
+/**
+ *  \brief Cache for results of unary operations and operations
+ *  with integer parameters.
+ *
+ *  Key of an entry is operation id, two integer parameters and up to two
+ *  operands. Unused parameters are 0 and unused operand is nullptr.
+ */
+template<class Data, class Degree>
+class computed_table
+{
+public:
+    using node_t = node<Data, Degree>;
+
+public:
+    struct table_entry
+    {
+        int32 opId_;
+        int32 arg1_;
+        int32 arg2_;
+        node_t* lhs_;
+        node_t* rhs_;
+        node_t* result_;
+    };
+
+public:
+    computed_table(int64 capacity);
+    computed_table(computed_table&& other) noexcept;
+    ~computed_table();
+
+    computed_table(computed_table const&)  = delete;
+    auto operator= (computed_table const&) = delete;
+    auto operator= (computed_table&&)      = delete;
+
+public:
+    /**
+     *  \brief Looks up result of an operation
+     *  \param opId id of the operation
+     *  \param lhs first operand
+     *  \param rhs second operand or nullptr
+     *  \param arg1 first parameter of the operation
+     *  \param arg2 second parameter of the operation
+     *  \result result of the previous operation or nullptr
+     */
+    auto find (int32 opId, node_t* lhs, node_t* rhs, int32 arg1, int32 arg2)
+        -> node_t*;
+
+    /**
+     *  \brief Puts the result into the table possibly overwriting old value
+     *  \param opId id of the operation
+     *  \param result result
+     *  \param lhs first operand
+     *  \param rhs second operand or nullptr
+     *  \param arg1 first parameter of the operation
+     *  \param arg2 second parameter of the operation
+     */
+    auto put (
+        int32 opId,
+        node_t* result,
+        node_t* lhs,
+        node_t* rhs,
+        int32 arg1,
+        int32 arg2
+    ) -> void;
+
+    /**
+     *  \brief Increases the capacity so that it is close to \p aproxCapacity
+     *  Never lowers the capacity!
+     *  \param aproxCapacity new capacity
+     */
+    auto grow_capacity (int64 aproxCapacity) -> void;
+
+    /**
+     *  \brief Removes entries pointing to unused nodes
+     */
+    auto remove_unused () -> void;
+
+    /**
+     *  \brief Clears all entries
+     */
+    auto clear () -> void;
+
+private:
+    /**
+     *  \return Current load factor
+     */
+    [[nodiscard]] auto get_load_factor () const -> double;
+
+    /**
+     *  \brief Adjusts capacity of the table (number of entries)
+     *  \param newCapacity New capacity
+     */
+    auto rehash (int64 newCapacity) -> void;
+
+    /**
+     *  \brief Allocates \p count nullptr initialized entries
+     */
+    [[nodiscard]] static auto callocate_entries (int64 count) -> table_entry*;
+
+private:
+    int64 size_;
+    int64 capacity_;
+    table_entry* entries_;
+};
+
 // table_base definitions:
 
 inline auto table_base::get_gte_capacity(int64 const desiredCapacity) -> int64
@@ -802,8 +1005,9 @@ auto apply_cache<Data, Degree>::remove_unused() -> void
         cache_entry& entry = entries_[i];
         if (entry.result_)
         {
-            bool const isUsed = entry.lhs_->is_used() && entry.rhs_->is_used()
-                             && entry.result_->is_used();
+            bool const isUsed = regular_edge(entry.lhs_)->is_used()
+                             && regular_edge(entry.rhs_)->is_used()
+                             && regular_edge(entry.result_)->is_used();
             if (not isUsed)
             {
                 entry = cache_entry {};
@@ -872,6 +1076,400 @@ auto apply_cache<Data, Degree>::callocate_entries(int64 const count)
     );
 }
 
+// computed_table definitions:
+
+template<class Data, class Degree>
+computed_table<Data, Degree>::computed_table(int64 const capacity) :
+    size_(0),
+    capacity_(table_base::get_gte_capacity(capacity)),
+    entries_(callocate_entries(capacity_))
+{
+}
+
+template<class Data, class Degree>
+computed_table<Data, Degree>::computed_table(computed_table&& other) noexcept :
+    size_(utils::exchange(other.size_, 0)),
+    capacity_(other.capacity_),
+    entries_(utils::exchange(other.entries_, nullptr))
+{
+}
+
+template<class Data, class Degree>
+computed_table<Data, Degree>::~computed_table()
+{
+    std::free(entries_);
+}
+
+template<class Data, class Degree>
+auto computed_table<Data, Degree>::find(
+    int32 const opId,
+    node_t* const lhs,
+    node_t* const rhs,
+    int32 const arg1,
+    int32 const arg2
+) -> node_t*
+{
+    std::size_t const hash  = utils::pack_hash(opId, lhs, rhs, arg1, arg2);
+    std::size_t const index = hash % static_cast<std::size_t>(capacity_);
+    table_entry& entry      = entries_[index];
+    bool const matches      = entry.opId_ == opId && entry.lhs_ == lhs
+                      && entry.rhs_ == rhs && entry.arg1_ == arg1
+                      && entry.arg2_ == arg2;
+    return matches ? entry.result_ : nullptr;
+}
+
+template<class Data, class Degree>
+auto computed_table<Data, Degree>::put(
+    int32 const opId,
+    node_t* const result,
+    node_t* const lhs,
+    node_t* const rhs,
+    int32 const arg1,
+    int32 const arg2
+) -> void
+{
+    std::size_t const hash  = utils::pack_hash(opId, lhs, rhs, arg1, arg2);
+    std::size_t const index = hash % static_cast<std::size_t>(capacity_);
+    table_entry& entry      = entries_[index];
+    if (not entry.result_)
+    {
+        ++size_;
+    }
+    entry.opId_   = opId;
+    entry.arg1_   = arg1;
+    entry.arg2_   = arg2;
+    entry.lhs_    = lhs;
+    entry.rhs_    = rhs;
+    entry.result_ = result;
+}
+
+template<class Data, class Degree>
+auto computed_table<Data, Degree>::grow_capacity(int64 const aproxCapacity)
+    -> void
+{
+    int64 const newCapacity = table_base::get_gte_capacity(aproxCapacity);
+    if (newCapacity > capacity_)
+    {
+        this->rehash(newCapacity);
+    }
+}
+
+template<class Data, class Degree>
+auto computed_table<Data, Degree>::remove_unused() -> void
+{
+    for (int64 i = 0; i < capacity_; ++i)
+    {
+        table_entry& entry = entries_[i];
+        if (entry.result_)
+        {
+            bool const isUsed
+                = regular_edge(entry.lhs_)->is_used()
+               && (not entry.rhs_ || regular_edge(entry.rhs_)->is_used())
+               && regular_edge(entry.result_)->is_used();
+            if (not isUsed)
+            {
+                entry = table_entry {};
+                --size_;
+            }
+        }
+    }
+}
+
+template<class Data, class Degree>
+auto computed_table<Data, Degree>::clear() -> void
+{
+    size_ = 0;
+    std::memset(
+        entries_,
+        0,
+        static_cast<std::size_t>(capacity_) * sizeof(table_entry)
+    );
+}
+
+template<class Data, class Degree>
+auto computed_table<Data, Degree>::get_load_factor() const -> double
+{
+    return static_cast<double>(size_) / static_cast<double>(capacity_);
+}
+
+template<class Data, class Degree>
+auto computed_table<Data, Degree>::rehash(int64 const newCapacity) -> void
+{
+#ifdef LIBTEDDY_VERBOSE
+    debug::out(
+        "computed_table::rehash\tload is ",
+        this->get_load_factor(),
+        ", capacity is ",
+        capacity_,
+        " should be ",
+        newCapacity
+    );
+#endif
+
+    table_entry* const oldEntries = entries_;
+    int64 const oldCapacity       = capacity_;
+    entries_                      = callocate_entries(newCapacity);
+    capacity_                     = newCapacity;
+    size_                         = 0;
+    for (int64 i = 0; i < oldCapacity; ++i)
+    {
+        table_entry const& entry = oldEntries[i];
+        if (entry.result_)
+        {
+            this->put(
+                entry.opId_,
+                entry.result_,
+                entry.lhs_,
+                entry.rhs_,
+                entry.arg1_,
+                entry.arg2_
+            );
+        }
+    }
+    std::free(oldEntries);
+
+#ifdef LIBTEDDY_VERBOSE
+    debug::out(" new load is ", this->get_load_factor(), "\n");
+#endif
+}
+
+template<class Data, class Degree>
+auto computed_table<Data, Degree>::callocate_entries(int64 const count)
+    -> table_entry*
+{
+    return static_cast<table_entry*>(
+        std::calloc(static_cast<std::size_t>(count), sizeof(table_entry))
+    );
+}
+
+// nary_apply_cache definitions:
+
+template<class Data, class Degree>
+nary_apply_cache<Data, Degree>::nary_apply_cache(int64 const capacity) :
+    size_(0),
+    capacity_(table_base::get_gte_capacity(capacity)),
+    arity_(2),
+    opIds_(static_cast<int32*>(
+        std::calloc(static_cast<std::size_t>(capacity_), sizeof(int32))
+    )),
+    entries_(static_cast<node_t**>(std::calloc(
+        static_cast<std::size_t>(capacity_ * (1 + arity_)),
+        sizeof(node_t*)
+    )))
+{
+}
+
+template<class Data, class Degree>
+nary_apply_cache<Data, Degree>::nary_apply_cache(nary_apply_cache&& other
+) noexcept :
+    size_(utils::exchange(other.size_, 0)),
+    capacity_(other.capacity_),
+    arity_(other.arity_),
+    opIds_(utils::exchange(other.opIds_, nullptr)),
+    entries_(utils::exchange(other.entries_, nullptr))
+{
+}
+
+template<class Data, class Degree>
+nary_apply_cache<Data, Degree>::~nary_apply_cache()
+{
+    std::free(opIds_);
+    std::free(entries_);
+}
+
+template<class Data, class Degree>
+auto nary_apply_cache<Data, Degree>::find(
+    int32 const opId,
+    node_t* const* const operands,
+    int32 const operandCount
+) -> node_t*
+{
+    if (operandCount > arity_)
+    {
+        return nullptr;
+    }
+
+    std::size_t const index = this->get_index(opId, operands, operandCount);
+    node_t** const entry    = this->get_entry(index);
+    if (opIds_[index] != opId)
+    {
+        return nullptr;
+    }
+
+    for (int32 k = 0; k < operandCount; ++k)
+    {
+        if (entry[1 + k] != operands[k])
+        {
+            return nullptr;
+        }
+    }
+
+    // Same operation with more operands:
+    if (operandCount < arity_ && entry[1 + operandCount])
+    {
+        return nullptr;
+    }
+
+    return entry[0];
+}
+
+template<class Data, class Degree>
+auto nary_apply_cache<Data, Degree>::put(
+    int32 const opId,
+    node_t* const result,
+    node_t* const* const operands,
+    int32 const operandCount
+) -> void
+{
+    if (operandCount > arity_)
+    {
+        this->rehash(capacity_, operandCount);
+    }
+
+    std::size_t const index = this->get_index(opId, operands, operandCount);
+    node_t** const entry    = this->get_entry(index);
+    if (not entry[0])
+    {
+        ++size_;
+    }
+    opIds_[index] = opId;
+    entry[0]      = result;
+    for (int32 k = 0; k < arity_; ++k)
+    {
+        entry[1 + k] = k < operandCount ? operands[k] : nullptr;
+    }
+}
+
+template<class Data, class Degree>
+auto nary_apply_cache<Data, Degree>::grow_capacity(int64 const aproxCapacity)
+    -> void
+{
+    int64 const newCapacity = table_base::get_gte_capacity(aproxCapacity);
+    if (newCapacity > capacity_)
+    {
+        this->rehash(newCapacity, arity_);
+    }
+}
+
+template<class Data, class Degree>
+auto nary_apply_cache<Data, Degree>::remove_unused() -> void
+{
+    for (int64 i = 0; i < capacity_; ++i)
+    {
+        node_t** const entry = this->get_entry(as_uindex(i));
+        if (entry[0])
+        {
+            bool isUsed = regular_edge(entry[0])->is_used();
+            for (int32 k = 0; k < arity_ && entry[1 + k]; ++k)
+            {
+                isUsed = isUsed && regular_edge(entry[1 + k])->is_used();
+            }
+
+            if (not isUsed)
+            {
+                opIds_[i] = 0;
+                for (int32 k = 0; k <= arity_; ++k)
+                {
+                    entry[k] = nullptr;
+                }
+                --size_;
+            }
+        }
+    }
+}
+
+template<class Data, class Degree>
+auto nary_apply_cache<Data, Degree>::clear() -> void
+{
+    size_ = 0;
+    std::memset(opIds_, 0, static_cast<std::size_t>(capacity_) * sizeof(int32));
+    std::memset(
+        entries_,
+        0,
+        static_cast<std::size_t>(capacity_ * (1 + arity_)) * sizeof(node_t*)
+    );
+}
+
+template<class Data, class Degree>
+auto nary_apply_cache<Data, Degree>::get_load_factor() const -> double
+{
+    return static_cast<double>(size_) / static_cast<double>(capacity_);
+}
+
+template<class Data, class Degree>
+auto nary_apply_cache<Data, Degree>::get_entry(std::size_t const index) const
+    -> node_t**
+{
+    return entries_ + index * static_cast<std::size_t>(1 + arity_);
+}
+
+template<class Data, class Degree>
+auto nary_apply_cache<Data, Degree>::get_index(
+    int32 const opId,
+    node_t* const* const operands,
+    int32 const operandCount
+) const -> std::size_t
+{
+    std::size_t hash = utils::do_hash(opId);
+    for (int32 k = 0; k < operandCount; ++k)
+    {
+        utils::add_hash(hash, static_cast<void*>(operands[k]));
+    }
+    return hash % static_cast<std::size_t>(capacity_);
+}
+
+template<class Data, class Degree>
+auto nary_apply_cache<Data, Degree>::rehash(
+    int64 const newCapacity,
+    int32 const newArity
+) -> void
+{
+#ifdef LIBTEDDY_VERBOSE
+    debug::out(
+        "nary_apply_cache::rehash\tload is ",
+        this->get_load_factor(),
+        ", capacity is ",
+        capacity_,
+        " should be ",
+        newCapacity
+    );
+#endif
+
+    int32* const oldOpIds     = opIds_;
+    node_t** const oldEntries = entries_;
+    int64 const oldCapacity   = capacity_;
+    int32 const oldArity      = arity_;
+    capacity_                 = newCapacity;
+    arity_                    = newArity;
+    size_                     = 0;
+    opIds_                    = static_cast<int32*>(
+        std::calloc(static_cast<std::size_t>(capacity_), sizeof(int32))
+    );
+    entries_ = static_cast<node_t**>(std::calloc(
+        static_cast<std::size_t>(capacity_ * (1 + arity_)),
+        sizeof(node_t*)
+    ));
+    for (int64 i = 0; i < oldCapacity; ++i)
+    {
+        node_t** const entry = oldEntries + i * (1 + oldArity);
+        if (entry[0])
+        {
+            int32 operandCount = 0;
+            while (operandCount < oldArity && entry[1 + operandCount])
+            {
+                ++operandCount;
+            }
+            this->put(oldOpIds[i], entry[0], entry + 1, operandCount);
+        }
+    }
+    std::free(oldOpIds);
+    std::free(oldEntries);
+
+#ifdef LIBTEDDY_VERBOSE
+    debug::out(" new load is ", this->get_load_factor(), "\n");
+#endif
+}
+
 } // namespace teddy
 
 #endif
\ No newline at end of file
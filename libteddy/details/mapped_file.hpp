@@ -0,0 +1,330 @@
+#ifndef LIBTEDDY_DETAILS_MAPPED_FILE_HPP
+#define LIBTEDDY_DETAILS_MAPPED_FILE_HPP
+
+#include <libteddy/details/config.hpp>
+#include <libteddy/details/types.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// POSIX headers declare names such as open, read and close in the global
+// namespace. They are only included when mapping is explicitly enabled,
+// see LIBTEDDY_MAPPED_FILES in config.hpp.
+#if defined(LIBTEDDY_MAPPED_FILES) && (defined(__unix__) || defined(__APPLE__))
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#    define LIBTEDDY_DETAILS_HAS_MMAP
+#endif
+
+namespace teddy
+{
+/**
+ *  \brief Read-only view of the whole content of a file
+ *
+ *  The file is memory-mapped if \c LIBTEDDY_MAPPED_FILES is defined and
+ *  the platform supports it so that its content is not copied. Otherwise,
+ *  the file is read into a buffer.
+ */
+class mapped_file
+{
+public:
+    /**
+     *  \brief Expected way of reading the mapped content
+     */
+    enum class access
+    {
+        /**
+         *  \brief Content is read once from the beginning to the end
+         */
+        Sequential,
+
+        /**
+         *  \brief Content is read at random offsets
+         */
+        Random
+    };
+
+public:
+    /**
+     *  \brief Opens and maps the file at \p path
+     *  Use \c is_open to check whether it succeeded
+     *  \param advice Hint for the paging of the mapped content
+     */
+    mapped_file(std::string const& path, access advice);
+
+    mapped_file(mapped_file const&) = delete;
+    mapped_file(mapped_file&& other) noexcept;
+    ~mapped_file();
+
+    auto operator= (mapped_file const&) -> mapped_file& = delete;
+    auto operator= (mapped_file&&) -> mapped_file&      = delete;
+
+    /**
+     *  \return True if the file was opened successfully
+     */
+    [[nodiscard]] auto is_open () const -> bool;
+
+    /**
+     *  \return Content of the file
+     */
+    [[nodiscard]] auto get_view () const -> std::string_view;
+
+private:
+    char const* data_;
+    std::size_t size_;
+    bool isOpen_;
+    bool isMapped_;
+    std::vector<char> buffer_;
+};
+
+inline mapped_file::mapped_file(
+    std::string const& path,
+    [[maybe_unused]] access const advice
+) :
+    data_(nullptr),
+    size_(0),
+    isOpen_(false),
+    isMapped_(false),
+    buffer_()
+{
+#ifdef LIBTEDDY_DETAILS_HAS_MMAP
+    int const fd = ::open(path.c_str(), O_RDONLY);
+    if (fd != -1)
+    {
+        struct stat info {};
+        if (::fstat(fd, &info) == 0)
+        {
+            size_   = static_cast<std::size_t>(info.st_size);
+            isOpen_ = true;
+            if (size_ > 0)
+            {
+                void* const address
+                    = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (address != MAP_FAILED)
+                {
+                    ::madvise(
+                        address,
+                        size_,
+                        advice == access::Sequential ? MADV_SEQUENTIAL
+                                                     : MADV_RANDOM
+                    );
+                    data_     = static_cast<char const*>(address);
+                    isMapped_ = true;
+                }
+            }
+        }
+        ::close(fd);
+    }
+
+    if (isMapped_ || (isOpen_ && size_ == 0))
+    {
+        return;
+    }
+#endif
+
+    // Fallback, read the whole file into memory.
+    auto ifst = std::ifstream(path, std::ios::binary);
+    if (not ifst.is_open())
+    {
+        isOpen_ = false;
+        return;
+    }
+    buffer_.assign(
+        std::istreambuf_iterator<char>(ifst),
+        std::istreambuf_iterator<char>()
+    );
+    data_   = buffer_.data();
+    size_   = buffer_.size();
+    isOpen_ = true;
+}
+
+inline mapped_file::mapped_file(mapped_file&& other) noexcept :
+    data_(other.data_),
+    size_(other.size_),
+    isOpen_(other.isOpen_),
+    isMapped_(other.isMapped_),
+    buffer_(static_cast<std::vector<char>&&>(other.buffer_))
+{
+    if (not isMapped_)
+    {
+        data_ = buffer_.data();
+    }
+    other.data_     = nullptr;
+    other.size_     = 0;
+    other.isOpen_   = false;
+    other.isMapped_ = false;
+}
+
+inline mapped_file::~mapped_file()
+{
+#ifdef LIBTEDDY_DETAILS_HAS_MMAP
+    if (isMapped_)
+    {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+}
+
+inline auto mapped_file::is_open() const -> bool
+{
+    return isOpen_;
+}
+
+inline auto mapped_file::get_view() const -> std::string_view
+{
+    return std::string_view(data_, size_);
+}
+
+/**
+ *  \brief Reads a text file line by line
+ *
+ *  If \c LIBTEDDY_MAPPED_FILES is defined and the platform supports it,
+ *  lines are views into the mapped file. Otherwise, the file is streamed
+ *  through a fixed-size buffer that only grows if a single line does not
+ *  fit into it. In both cases, the memory needed does not depend on the
+ *  size of the file.
+ */
+class line_reader
+{
+public:
+    /**
+     *  \brief Opens the file at \p path
+     *  Use \c is_open to check whether it succeeded
+     */
+    explicit line_reader(std::string const& path);
+
+    /**
+     *  \return True if the file was opened successfully
+     */
+    [[nodiscard]] auto is_open () const -> bool;
+
+    /**
+     *  \brief Reads the next line without the line break
+     *
+     *  \p line is only valid until the next call.
+     *
+     *  \param line Output parameter for the line
+     *  \return False if there are no more lines
+     */
+    auto next_line (std::string_view& line) -> bool;
+
+private:
+    static constexpr std::size_t BufferSize = 64 * 1'024;
+
+private:
+#ifdef LIBTEDDY_DETAILS_HAS_MMAP
+    mapped_file file_;
+    std::string_view text_;
+    std::size_t position_;
+#else
+    std::ifstream stream_;
+    std::vector<char> buffer_;
+    std::size_t first_;
+    std::size_t last_;
+    bool isEnd_;
+#endif
+};
+
+#ifdef LIBTEDDY_DETAILS_HAS_MMAP
+
+inline line_reader::line_reader(std::string const& path) :
+    file_(path, mapped_file::access::Sequential),
+    text_(file_.get_view()),
+    position_(0)
+{
+}
+
+inline auto line_reader::is_open() const -> bool
+{
+    return file_.is_open();
+}
+
+inline auto line_reader::next_line(std::string_view& line) -> bool
+{
+    if (position_ >= text_.size())
+    {
+        return false;
+    }
+    std::size_t last = text_.find('\n', position_);
+    if (last == std::string_view::npos)
+    {
+        last = text_.size();
+    }
+    line      = text_.substr(position_, last - position_);
+    position_ = last + 1;
+    return true;
+}
+
+#else
+
+inline line_reader::line_reader(std::string const& path) :
+    stream_(path, std::ios::binary),
+    buffer_(BufferSize),
+    first_(0),
+    last_(0),
+    isEnd_(false)
+{
+}
+
+inline auto line_reader::is_open() const -> bool
+{
+    return stream_.is_open();
+}
+
+inline auto line_reader::next_line(std::string_view& line) -> bool
+{
+    for (;;)
+    {
+        char const* const data = buffer_.data();
+        void const* const lineBreak
+            = std::memchr(data + first_, '\n', last_ - first_);
+        if (lineBreak != nullptr)
+        {
+            std::size_t const end = as_usize(
+                static_cast<char const*>(lineBreak) - data
+            );
+            line   = std::string_view(data + first_, end - first_);
+            first_ = end + 1;
+            return true;
+        }
+
+        if (isEnd_)
+        {
+            if (first_ == last_)
+            {
+                return false;
+            }
+            // Last line without the line break.
+            line   = std::string_view(data + first_, last_ - first_);
+            first_ = last_;
+            return true;
+        }
+
+        // Move the incomplete line to the front and read more.
+        std::memmove(buffer_.data(), data + first_, last_ - first_);
+        last_  -= first_;
+        first_  = 0;
+        if (last_ == buffer_.size())
+        {
+            buffer_.resize(2 * buffer_.size());
+        }
+        stream_.read(
+            buffer_.data() + last_,
+            static_cast<std::streamsize>(buffer_.size() - last_)
+        );
+        std::streamsize const count = stream_.gcount();
+        last_ += static_cast<std::size_t>(count);
+        isEnd_ = count == 0 || not stream_;
+    }
+}
+
+#endif
+} // namespace teddy
+
+#endif
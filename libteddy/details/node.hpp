@@ -5,6 +5,7 @@
 #include <libteddy/details/types.hpp>
 
 #include <cassert>
+#include <cstdint>
 #include <cstdlib>
 
 namespace teddy
@@ -146,12 +147,14 @@ public:
     [[nodiscard]] auto get_sons () const -> son_container const&;
     [[nodiscard]] auto get_son (int32 sonOrder) const -> node*;
     [[nodiscard]] auto get_value () const -> int32;
+    [[nodiscard]] auto get_scratch () const -> int32;
     auto set_next (node* next) -> void;
     auto set_unused () -> void;
     auto set_marked () -> void;
     auto set_notmarked () -> void;
     auto set_index (int32 index) -> void;
     auto set_sons (son_container const& sons) -> void;
+    auto set_scratch (int32 scratch) -> void;
     auto toggle_marked () -> void;
     auto inc_ref_count () -> void;
     auto dec_ref_count () -> void;
@@ -194,13 +197,56 @@ private:
      *  29b -> reference count  (lowest bits)
      */
     uint32 bits_;
+    /*
+     *  Temporary value owned by the current traversal, e.g., index of
+     *  the node in a dense array. Fits into the padding after bits_.
+     */
+    int32 scratch_;
 };
 
+/**
+ *  \brief Returns \p edge with toggled complement tag
+ *
+ *  Complement tag is stored in the lowest bit of the pointer.
+ *  Nodes are always at least pointer aligned so the bit is otherwise
+ *  unused. Managers without complement edges never set it.
+ */
+template<class Data, class Degree>
+auto complement_edge (node<Data, Degree>* const edge) -> node<Data, Degree>*
+{
+    return reinterpret_cast<node<Data, Degree>*>(
+        reinterpret_cast<std::uintptr_t>(edge) ^ std::uintptr_t(1)
+    );
+}
+
+/**
+ *  \brief Checks whether \p edge carries the complement tag
+ */
+template<class Data, class Degree>
+auto is_complemented (node<Data, Degree>* const edge) -> bool
+{
+    return static_cast<bool>(
+        reinterpret_cast<std::uintptr_t>(edge) & std::uintptr_t(1)
+    );
+}
+
+/**
+ *  \brief Returns pointer to the node that \p edge points to
+ */
+template<class Data, class Degree>
+auto regular_edge (node<Data, Degree>* const edge) -> node<Data, Degree>*
+{
+    return reinterpret_cast<node<Data, Degree>*>(
+        reinterpret_cast<std::uintptr_t>(edge) & ~std::uintptr_t(1)
+    );
+}
+
 template<class Data, class Degree>
 node<Data, Degree>::node(int32 const value) :
     terminal_ {value},
     next_ {nullptr},
-    bits_ {LeafM | UsedM}
+    bits_ {LeafM | UsedM},
+    scratch_ {0}
 {
 }
 
@@ -208,7 +254,8 @@ template<class Data, class Degree>
 node<Data, Degree>::node(int32 const index, son_container sons) :
     internal_ {sons, index},
     next_ {nullptr},
-    bits_ {UsedM}
+    bits_ {UsedM},
+    scratch_ {0}
 {
 }
 
@@ -362,6 +409,18 @@ auto node<Data, Degree>::get_index() const -> int32
     return internal_.index_;
 }
 
+template<class Data, class Degree>
+auto node<Data, Degree>::get_scratch() const -> int32
+{
+    return scratch_;
+}
+
+template<class Data, class Degree>
+auto node<Data, Degree>::set_scratch(int32 const scratch) -> void
+{
+    scratch_ = scratch;
+}
+
 template<class Data, class Degree>
 auto node<Data, Degree>::set_index(int32 const index) -> void
 {
@@ -133,6 +133,10 @@ public:
         int32 index,
         son_container const& sons
     ) -> node_t*;
+    [[nodiscard]] auto make_zero_suppressed_node (
+        int32 index,
+        son_container const& sons
+    ) -> node_t*;
     [[nodiscard]] auto make_son_container (int32 domain) -> son_container;
     [[nodiscard]] auto get_level (int32 index) const -> int32;
     [[nodiscard]] auto get_level (node_t* node) const -> int32;
@@ -178,6 +182,38 @@ public:
 
     auto cache_clear () -> void;
 
+    [[nodiscard]] auto cache_find_n (
+        int32 opId,
+        node_t* const* operands,
+        int32 operandCount
+    ) -> node_t*;
+
+    auto cache_put_n (
+        int32 opId,
+        node_t* result,
+        node_t* const* operands,
+        int32 operandCount
+    ) -> void;
+
+    [[nodiscard]] auto computed_find (
+        int32 opId,
+        node_t* lhs,
+        node_t* rhs,
+        int32 arg1,
+        int32 arg2
+    ) -> node_t*;
+
+    auto computed_put (
+        int32 opId,
+        node_t* result,
+        node_t* lhs,
+        node_t* rhs,
+        int32 arg1,
+        int32 arg2
+    ) -> void;
+
+    [[nodiscard]] auto make_operation_id () -> int32;
+
     template<class NodeOp>
     auto traverse_pre (node_t* rootNode, NodeOp operation) const -> void;
 
@@ -187,6 +223,39 @@ public:
     template<class NodeOp>
     auto traverse_level (node_t* rootNode, NodeOp operation) const -> void;
 
+    /**
+     *  \brief Post-order traversal that numbers the nodes
+     *
+     *  Before \p operation is called on a node, the node gets id
+     *  (see \c node::get_scratch) that is one greater than the id of
+     *  the previous node. Ids of sons can be used as indices into a dense
+     *  array of per-node values instead of a hash map.
+     *
+     *  \return Number of visited nodes
+     */
+    template<class NodeOp>
+    auto traverse_post_numbered (node_t* rootNode, NodeOp operation) const
+        -> int64;
+
+    /**
+     *  \brief Post-order traversal of the union of diagrams that numbers
+     *  the nodes
+     *
+     *  Nodes shared by multiple diagrams are visited only once.
+     *
+     *  \return Number of visited nodes
+     */
+    template<class NodeOp>
+    auto traverse_post_numbered (
+        std::vector<node_t*> const& rootNodes,
+        NodeOp operation
+    ) const -> int64;
+
+    /**
+     *  \brief Returns empty buffer that is reused by bottom-up analyses
+     */
+    [[nodiscard]] auto get_scratch_buffer () const -> std::vector<int64>&;
+
     [[nodiscard]] auto is_valid_var_value (int32 index, int32 value) const
         -> bool;
 
@@ -206,6 +275,16 @@ private:
     [[nodiscard]] auto is_redundant (int32 index, son_container const& sons)
         const -> bool;
 
+    [[nodiscard]] auto is_zero_suppressed (
+        int32 index,
+        son_container const& sons
+    ) const -> bool;
+
+    [[nodiscard]] auto make_unique_node (
+        int32 index,
+        son_container const& sons
+    ) -> node_t*;
+
     auto adjust_tables () -> void;
     auto adjust_caches () -> void;
 
@@ -233,24 +312,32 @@ private:
     [[nodiscard]] static auto can_be_gced (node_t* node) -> bool;
 
 private:
-    static constexpr int32 DEFAULT_FIRST_TABLE_ADJUSTMENT = 230;
-    static constexpr double DEFAULT_CACHE_RATIO           = 1.0;
-    static constexpr double DEFAULT_GC_RATIO              = 0.20;
+    static constexpr int32 DEFAULT_FIRST_TABLE_ADJUSTMENT  = 230;
+    static constexpr double DEFAULT_CACHE_RATIO            = 1.0;
+    static constexpr double DEFAULT_GC_RATIO               = 0.20;
+    static constexpr int64 DEFAULT_NARY_CACHE_CAPACITY     = 1'000;
+    static constexpr int64 DEFAULT_COMPUTED_TABLE_CAPACITY = 1'000;
+    static constexpr int32 FIRST_OPERATION_ID              = 1'024;
+    static constexpr int32 LAST_OPERATION_ID               = 1'000'000'000;
 
 private:
     apply_cache<Data, Degree> opCache_;
+    nary_apply_cache<Data, Degree> naryCache_;
+    computed_table<Data, Degree> computedTable_;
     node_pool<Data, Degree> pool_;
     std::vector<unique_table<Data, Degree>> uniqueTables_;
     std::vector<node_t*> terminals_;
     std::vector<node_t*> specials_;
     std::vector<int32> indexToLevel_;
     std::vector<int32> levelToIndex_;
+    mutable std::vector<int64> scratchBuffer_;
     [[no_unique_address]] Domain domains_;
     int32 varCount_;
     int64 nodeCount_;
     int64 adjustmentNodeCount_;
     double cacheRatio_;
     double gcRatio_;
+    int32 nextOperationId_;
     bool autoReorderEnabled_;
     bool gcReorderDeferred_;
 };
@@ -259,7 +346,7 @@ template<class Data, class Degree>
 auto id_inc_ref_count (node<Data, Degree>* const node)
     -> ::teddy::node<Data, Degree>*
 {
-    node->inc_ref_count();
+    regular_edge(node)->inc_ref_count();
     return node;
 }
 
@@ -267,7 +354,7 @@ template<class Data, class Degree>
 auto id_set_marked (node<Data, Degree>* const node)
     -> ::teddy::node<Data, Degree>*
 {
-    node->set_marked();
+    regular_edge(node)->set_marked();
     return node;
 }
 
@@ -275,7 +362,7 @@ template<class Data, class Degree>
 auto id_set_notmarked (node<Data, Degree>* const node)
     -> ::teddy::node<Data, Degree>*
 {
-    node->set_notmarked();
+    regular_edge(node)->set_notmarked();
     return node;
 }
 
@@ -332,18 +419,22 @@ node_manager<Data, Degree, Domain>::node_manager(
     opCache_(static_cast<int64>(
         DEFAULT_CACHE_RATIO * static_cast<double>(nodePoolSize)
     )),
+    naryCache_(DEFAULT_NARY_CACHE_CAPACITY),
+    computedTable_(DEFAULT_COMPUTED_TABLE_CAPACITY),
     pool_(nodePoolSize, extraNodePoolSize),
     uniqueTables_(),
     terminals_(),
     specials_(),
     indexToLevel_(as_usize(varCount)),
     levelToIndex_(static_cast<std::vector<int32>&&>(order)),
+    scratchBuffer_(),
     domains_(static_cast<Domain&&>(domains)),
     varCount_(varCount),
     nodeCount_(0),
     adjustmentNodeCount_(DEFAULT_FIRST_TABLE_ADJUSTMENT),
     cacheRatio_(DEFAULT_CACHE_RATIO),
     gcRatio_(DEFAULT_GC_RATIO),
+    nextOperationId_(FIRST_OPERATION_ID),
     autoReorderEnabled_(false),
     gcReorderDeferred_(false)
 {
@@ -492,6 +583,22 @@ auto node_manager<Data, Degree, Domain>::make_internal_node(
     son_container const& sons
 ) -> node_t*
 {
+    // complemented 1-son:
+    if constexpr (std::is_same_v<Degree, degrees::fixed<2>>)
+    {
+        if (is_complemented(sons[1]))
+        {
+            // Canonical form keeps the 1-son regular, the complement
+            // is moved to the edge pointing to the new node.
+            son_container regularSons;
+            regularSons[0] = complement_edge(sons[0]);
+            regularSons[1] = complement_edge(sons[1]);
+            return complement_edge(
+                this->make_internal_node(index, regularSons)
+            );
+        }
+    }
+
     // redundant node:
     if (this->is_redundant(index, sons))
     {
@@ -503,6 +610,35 @@ auto node_manager<Data, Degree, Domain>::make_internal_node(
         return son;
     }
 
+    return this->make_unique_node(index, sons);
+}
+
+template<class Data, class Degree, class Domain>
+auto node_manager<Data, Degree, Domain>::make_zero_suppressed_node(
+    int32 const index,
+    son_container const& sons
+) -> node_t*
+{
+    // zero-suppressed node:
+    if (this->is_zero_suppressed(index, sons))
+    {
+        node_t* const son = sons[0];
+        if constexpr (degrees::is_mixed<Degree>::value)
+        {
+            node_t::delete_son_container(sons);
+        }
+        return son;
+    }
+
+    return this->make_unique_node(index, sons);
+}
+
+template<class Data, class Degree, class Domain>
+auto node_manager<Data, Degree, Domain>::make_unique_node(
+    int32 const index,
+    son_container const& sons
+) -> node_t*
+{
     // duplicate node:
     unique_table<Data, Degree>& table = uniqueTables_[as_uindex(index)];
     auto const [existing, hash]       = table.find(sons);
@@ -623,6 +759,8 @@ auto node_manager<Data, Degree, Domain>::force_gc() -> void
 {
     this->collect_garbage();
     opCache_.remove_unused();
+    naryCache_.remove_unused();
+    computedTable_.remove_unused();
 }
 
 template<class Data, class Degree, class Domain>
@@ -834,6 +972,77 @@ template<class Data, class Degree, class Domain>
 auto node_manager<Data, Degree, Domain>::cache_clear() -> void
 {
     opCache_.clear();
+    naryCache_.clear();
+    computedTable_.clear();
+}
+
+template<class Data, class Degree, class Domain>
+auto node_manager<Data, Degree, Domain>::cache_find_n(
+    int32 const opId,
+    node_t* const* const operands,
+    int32 const operandCount
+) -> node_t*
+{
+    node_t* const node = naryCache_.find(opId, operands, operandCount);
+    if (node)
+    {
+        id_set_marked(node);
+    }
+    return node;
+}
+
+template<class Data, class Degree, class Domain>
+auto node_manager<Data, Degree, Domain>::cache_put_n(
+    int32 const opId,
+    node_t* const result,
+    node_t* const* const operands,
+    int32 const operandCount
+) -> void
+{
+    naryCache_.put(opId, result, operands, operandCount);
+}
+
+template<class Data, class Degree, class Domain>
+auto node_manager<Data, Degree, Domain>::computed_find(
+    int32 const opId,
+    node_t* const lhs,
+    node_t* const rhs,
+    int32 const arg1,
+    int32 const arg2
+) -> node_t*
+{
+    node_t* const node = computedTable_.find(opId, lhs, rhs, arg1, arg2);
+    if (node)
+    {
+        id_set_marked(node);
+    }
+    return node;
+}
+
+template<class Data, class Degree, class Domain>
+auto node_manager<Data, Degree, Domain>::computed_put(
+    int32 const opId,
+    node_t* const result,
+    node_t* const lhs,
+    node_t* const rhs,
+    int32 const arg1,
+    int32 const arg2
+) -> void
+{
+    computedTable_.put(opId, result, lhs, rhs, arg1, arg2);
+}
+
+template<class Data, class Degree, class Domain>
+auto node_manager<Data, Degree, Domain>::make_operation_id() -> int32
+{
+    if (nextOperationId_ == LAST_OPERATION_ID)
+    {
+        // Old entries could be mistaken for results of new operations.
+        nextOperationId_ = FIRST_OPERATION_ID;
+        naryCache_.clear();
+        computedTable_.clear();
+    }
+    return nextOperationId_++;
 }
 
 template<class Data, class Degree, class Domain>
@@ -852,6 +1061,8 @@ auto node_manager<Data, Degree, Domain>::run_deferred() -> void
     {
         this->collect_garbage();
         opCache_.clear();
+        naryCache_.clear();
+        computedTable_.clear();
         this->sift_variables();
     }
 }
@@ -863,8 +1074,8 @@ auto node_manager<Data, Degree, Domain>::traverse_pre(
     NodeOp const operation
 ) const -> void
 {
-    this->traverse_pre_impl(rootNode, operation);
-    this->traverse_pre_impl(rootNode, [] (node_t*) {});
+    this->traverse_pre_impl(regular_edge(rootNode), operation);
+    this->traverse_pre_impl(regular_edge(rootNode), [] (node_t*) {});
     // Second traverse to reset marks
 }
 
@@ -882,7 +1093,7 @@ auto node_manager<Data, Degree, Domain>::traverse_pre_impl(
         int32 const nodeDomain = this->get_domain(node);
         for (int32 k = 0; k < nodeDomain; ++k)
         {
-            node_t* const son = node->get_son(k);
+            node_t* const son = regular_edge(node->get_son(k));
             if (node->is_marked() != son->is_marked())
             {
                 this->traverse_pre_impl(son, operation);
@@ -898,11 +1109,76 @@ auto node_manager<Data, Degree, Domain>::traverse_post(
     NodeOp operation
 ) const -> void
 {
-    this->traverse_post_impl(rootNode, operation);
-    this->traverse_post_impl(rootNode, [] (node_t*) {});
+    this->traverse_post_impl(regular_edge(rootNode), operation);
+    this->traverse_post_impl(regular_edge(rootNode), [] (node_t*) {});
     // Second traverse to reset marks.
 }
 
+template<class Data, class Degree, class Domain>
+template<class NodeOp>
+auto node_manager<Data, Degree, Domain>::traverse_post_numbered(
+    node_t* const rootNode,
+    NodeOp operation
+) const -> int64
+{
+    int32 nextId = 0;
+    this->traverse_post(
+        rootNode,
+        [&nextId, &operation] (node_t* const node)
+        {
+            node->set_scratch(nextId);
+            operation(node);
+            ++nextId;
+        }
+    );
+    return nextId;
+}
+
+template<class Data, class Degree, class Domain>
+template<class NodeOp>
+auto node_manager<Data, Degree, Domain>::traverse_post_numbered(
+    std::vector<node_t*> const& rootNodes,
+    NodeOp operation
+) const -> int64
+{
+    int32 nextId        = 0;
+    auto const numbered = [&nextId, &operation] (node_t* const node)
+    {
+        node->set_scratch(nextId);
+        operation(node);
+        ++nextId;
+    };
+
+    // Roots already marked were visited as part of a previous diagram.
+    for (node_t* const rootNode : rootNodes)
+    {
+        node_t* const root = regular_edge(rootNode);
+        if (not root->is_marked())
+        {
+            this->traverse_post_impl(root, numbered);
+        }
+    }
+
+    // Second traverse to reset marks.
+    for (node_t* const rootNode : rootNodes)
+    {
+        node_t* const root = regular_edge(rootNode);
+        if (root->is_marked())
+        {
+            this->traverse_post_impl(root, [] (node_t*) {});
+        }
+    }
+    return nextId;
+}
+
+template<class Data, class Degree, class Domain>
+auto node_manager<Data, Degree, Domain>::get_scratch_buffer() const
+    -> std::vector<int64>&
+{
+    scratchBuffer_.clear();
+    return scratchBuffer_;
+}
+
 template<class Data, class Degree, class Domain>
 template<class NodeOp>
 auto node_manager<Data, Degree, Domain>::traverse_post_impl(
@@ -916,7 +1192,7 @@ auto node_manager<Data, Degree, Domain>::traverse_post_impl(
         int32 const nodeDomain = this->get_domain(node);
         for (int32 k = 0; k < nodeDomain; ++k)
         {
-            node_t* const son = node->get_son(k);
+            node_t* const son = regular_edge(node->get_son(k));
             if (node->is_marked() != son->is_marked())
             {
                 this->traverse_post_impl(son, operation);
@@ -933,11 +1209,12 @@ auto node_manager<Data, Degree, Domain>::traverse_level(
     NodeOp operation
 ) const -> void
 {
+    node_t* const root = regular_edge(rootNode);
     std::vector<std::vector<node_t*>> buckets(as_usize(varCount_) + 1);
     auto const endBucketIt = end(buckets);
-    auto bucketIt          = begin(buckets) + this->get_level(rootNode);
-    (*bucketIt).push_back(rootNode);
-    rootNode->toggle_marked();
+    auto bucketIt          = begin(buckets) + this->get_level(root);
+    (*bucketIt).push_back(root);
+    root->toggle_marked();
 
     while (bucketIt != endBucketIt)
     {
@@ -949,7 +1226,7 @@ auto node_manager<Data, Degree, Domain>::traverse_level(
                 int32 const domain = this->get_domain(node);
                 for (int32 k = 0; k < domain; ++k)
                 {
-                    node_t* const son = node->get_son(k);
+                    node_t* const son = regular_edge(node->get_son(k));
                     if (son->is_marked() != node->is_marked())
                     {
                         int32 const level = this->get_level(son);
@@ -967,14 +1244,14 @@ auto node_manager<Data, Degree, Domain>::traverse_level(
     }
 
     // Second traverse to reset marks.
-    this->traverse_pre_impl(rootNode, [] (node_t*) {});
+    this->traverse_pre_impl(root, [] (node_t*) {});
 }
 
 template<class Data, class Degree, class Domain>
 auto node_manager<Data, Degree, Domain>::dec_ref_count(node_t* const node)
     -> void
 {
-    node->dec_ref_count();
+    regular_edge(node)->dec_ref_count();
 }
 
 template<class Data, class Degree, class Domain>
@@ -993,6 +1270,28 @@ auto node_manager<Data, Degree, Domain>::is_redundant(
     return true;
 }
 
+template<class Data, class Degree, class Domain>
+auto node_manager<Data, Degree, Domain>::is_zero_suppressed(
+    int32 const index,
+    son_container const& sons
+) const -> bool
+{
+    node_t* const zero = terminals_.empty() ? nullptr : terminals_[0];
+    if (not zero)
+    {
+        return false;
+    }
+
+    for (int32 j = 1; j < domains_[index]; ++j)
+    {
+        if (sons[as_uindex(j)] != zero)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 template<class Data, class Degree, class Domain>
 auto node_manager<Data, Degree, Domain>::adjust_tables() -> void
 {
@@ -1016,6 +1315,8 @@ auto node_manager<Data, Degree, Domain>::adjust_caches() -> void
 {
     auto const newCapacity = cacheRatio_ * static_cast<double>(nodeCount_);
     opCache_.grow_capacity(static_cast<int64>(newCapacity));
+    naryCache_.grow_capacity(static_cast<int64>(newCapacity));
+    computedTable_.grow_capacity(static_cast<int64>(newCapacity));
 }
 
 template<class Data, class Degree, class Domain>
@@ -1099,7 +1400,7 @@ auto node_manager<Data, Degree, Domain>::to_dot_graph_common(
     };
 
     auto const get_id_str = [] (node_t* const n)
-    { return std::to_string(reinterpret_cast<uint64>(n)); };
+    { return std::to_string(reinterpret_cast<uint64>(regular_edge(n))); };
 
     auto const output_range = [] (auto& ostr, auto const& range, auto const sep)
     {
@@ -1150,10 +1451,13 @@ auto node_manager<Data, Degree, Domain>::to_dot_graph_common(
                 {
                     if constexpr (std::is_same_v<Degree, degrees::fixed<2>>)
                     {
+                        std::string const style = is_complemented(son)
+                                                    ? "dotted"
+                                                : 0 == sonOrder ? "dashed"
+                                                                : "solid";
                         arcs.emplace_back(
                             get_id_str(node) + " -> " + get_id_str(son)
-                            + " [style = "
-                            + (0 == sonOrder ? "dashed" : "solid") + "];"
+                            + " [style = " + style + "];"
                         );
                     }
                     else
@@ -1320,7 +1624,7 @@ auto node_manager<Data, Degree, Domain>::dec_ref_try_gc(node_t* const node)
         int32 const nodeDomain = this->get_domain(node);
         for (int32 k = 0; k < nodeDomain; ++k)
         {
-            this->dec_ref_try_gc(node->get_son(k));
+            this->dec_ref_try_gc(regular_edge(node->get_son(k)));
         }
 
         uniqueTables_[as_uindex(node->get_index())].erase(node);
@@ -1467,6 +1771,10 @@ auto node_manager<Data, Degree, Domain>::sift_variables() -> void
     );
 #endif
 
+    // Swaps free nodes whose addresses are reused by the pool.
+    opCache_.clear();
+    naryCache_.clear();
+    computedTable_.clear();
     gcReorderDeferred_ = false;
 }
 } // namespace teddy
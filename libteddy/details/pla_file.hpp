@@ -2,22 +2,29 @@
 #define LIBTEDDY_DETAILS_PLA_FILE_HPP
 
 #include <libteddy/details/debug.hpp>
+#include <libteddy/details/mapped_file.hpp>
+#include <libteddy/details/stats.hpp>
 #include <libteddy/details/tools.hpp>
 #include <libteddy/details/types.hpp>
 
+#include <bit>
 #include <cassert>
-#include <cctype>
+#include <cstddef>
 #include <cstdint>
-#include <fstream>
 #include <optional>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 
 namespace teddy
 {
 /**
  *  \brief Bool cube.
+ *
+ *  Values are packed into 64-bit words. For each block of 64 variables,
+ *  the cube stores a care mask with bits set for variables that are not
+ *  \c DontCare and a value mask with their values. Value bits of \c DontCare
+ *  variables are always zero so that cubes can be compared word by word.
  */
 class bool_cube
 {
@@ -25,24 +32,61 @@ public:
     static constexpr std::uint8_t DontCare = 0b11;
 
 public:
+    /**
+     *  \brief Initializes cube where all variables have value 0
+     */
     bool_cube(int32 size);
 
     auto size () const -> int32;
     auto get (int32 index) const -> int32;
     auto set (int32 index, int32 value) -> void;
 
+    /**
+     *  \brief Checks whether all assignments of \p other are
+     *  assignments of this cube
+     */
+    [[nodiscard]] auto contains (bool_cube const& other) const -> bool;
+
+    /**
+     *  \brief Checks whether the cubes have a common assignment
+     */
+    [[nodiscard]] auto intersects (bool_cube const& other) const -> bool;
+
+    /**
+     *  \brief Creates cube with assignments common to both cubes
+     *  \return Optional holding the intersection or \c std::nullopt
+     *  if the cubes do not intersect
+     */
+    [[nodiscard]] auto intersection (bool_cube const& other) const
+        -> std::optional<bool_cube>;
+
+    /**
+     *  \return Number of variables that are 0 in one cube and 1 in the other
+     */
+    [[nodiscard]] auto distance (bool_cube const& other) const -> int32;
+
+    friend auto operator== (bool_cube const&, bool_cube const&) -> bool
+        = default;
+
 private:
-    struct byte
+    struct word_pair
     {
-        std::uint8_t b0 : 2;
-        std::uint8_t b1 : 2;
-        std::uint8_t b2 : 2;
-        std::uint8_t b3 : 2;
+        std::uint64_t care_;
+        std::uint64_t value_;
+
+        friend auto operator== (word_pair const&, word_pair const&) -> bool
+            = default;
     };
 
+private:
+    /**
+     *  \return Mask of bits that differ in cared variables
+     */
+    static auto conflicts (word_pair lhs, word_pair rhs) -> std::uint64_t;
+
 private:
     int32 size_;
-    std::vector<byte> values_;
+    std::vector<word_pair> words_;
 };
 
 /**
@@ -50,6 +94,28 @@ private:
  */
 class pla_file
 {
+public:
+    /**
+     *  \brief Represents one line of a PLA file.
+     */
+    struct pla_line
+    {
+        bool_cube cube_;
+        bool_cube fVals_;
+    };
+
+    /**
+     *  \brief Options from the header of a PLA file
+     */
+    struct pla_header
+    {
+        int32 varCount_;
+        int32 functionCount_;
+        int64 lineCount_;
+        std::vector<std::string> inputLabels_;
+        std::vector<std::string> outputLabels_;
+    };
+
 public:
     /**
      *  \brief Loads PLA file from a file at given path
@@ -59,15 +125,24 @@ public:
      */
     static auto load_file (std::string const& path) -> std::optional<pla_file>;
 
-public:
     /**
-     *  \brief Represents one line of a PLA file.
+     *  \brief Reads PLA file at given path without storing its lines
+     *
+     *  The file is read line by line using \c line_reader and each line
+     *  is parsed in place. \p lineOp is called with each line as soon as
+     *  it is parsed. The line is only valid during the call so the memory
+     *  needed does not depend on the size of the file. If the file is
+     *  invalid, \p lineOp might have been called for lines preceding
+     *  the error.
+     *
+     *  \param path Path to the file
+     *  \param lineOp Function called with each \c pla_line
+     *  \return Optional holding the header or \c std::nullopt
+     *  if the loading failed
      */
-    struct pla_line
-    {
-        bool_cube cube_;
-        bool_cube fVals_;
-    };
+    template<class LineOp>
+    static auto scan_file (std::string const& path, LineOp lineOp)
+        -> std::optional<pla_header>;
 
 public:
     /**
@@ -132,6 +207,28 @@ public:
     [[nodiscard]] auto get_output_labels () && -> std::vector<std::string>;
 
 private:
+    static auto load_file_impl (std::string const& path)
+        -> std::optional<pla_file>;
+
+    static auto is_space (char character) -> bool;
+
+    /**
+     *  \return Position of the first space in \p str starting
+     *  at \p position or size of \p str
+     */
+    static auto find_space (std::string_view str, std::size_t position)
+        -> std::size_t;
+
+    static auto trim (std::string_view str) -> std::string_view;
+
+    static auto to_words (std::string_view str) -> std::vector<std::string>;
+
+    /**
+     *  \brief Parses characters from \p str into \p cube
+     *  \return False if \p str is not a valid cube of the same size
+     */
+    static auto parse_cube (std::string_view str, bool_cube& cube) -> bool;
+
     pla_file(
         std::vector<pla_line> lines,
         std::vector<std::string> inputLabels,
@@ -148,8 +245,12 @@ private:
 
 inline bool_cube::bool_cube(int32 const size) :
     size_(size),
-    values_(as_usize(size / 4 + 1), byte {0, 0, 0, 0})
+    words_(as_usize((size + 63) / 64), word_pair {~std::uint64_t {0}, 0})
 {
+    if (size % 64 != 0)
+    {
+        words_.back().care_ = (std::uint64_t {1} << (size % 64)) - 1;
+    }
 }
 
 inline auto bool_cube::size() const -> int32
@@ -157,50 +258,104 @@ inline auto bool_cube::size() const -> int32
     return size_;
 }
 
-inline auto bool_cube::get(int32 const i) const -> int32
+inline auto bool_cube::get(int32 const index) const -> int32
 {
-    int32 const byteIndex        = i / 4;
-    std::size_t const uByteIndex = as_uindex(byteIndex);
-
-    assert(byteIndex >= 0 && byteIndex < ssize(values_));
+    assert(index >= 0 && index < size_);
 
-    switch (i % 4)
+    word_pair const& word   = words_[as_uindex(index / 64)];
+    std::uint64_t const bit = std::uint64_t {1} << (index % 64);
+    if ((word.care_ & bit) == 0)
     {
-    case 0:
-        return values_[uByteIndex].b0;
-    case 1:
-        return values_[uByteIndex].b1;
-    case 2:
-        return values_[uByteIndex].b2;
-    case 3:
-        return values_[uByteIndex].b3;
+        return DontCare;
     }
-    return -1;
+    return (word.value_ & bit) != 0 ? 1 : 0;
 }
 
 inline auto bool_cube::set(int32 const index, int32 const value) -> void
 {
-    int32 const byteIndex        = index / 4;
-    std::size_t const uByteIndex = as_uindex(byteIndex);
-
-    assert((byteIndex >= 0 && byteIndex < ssize(values_)));
+    assert(index >= 0 && index < size_);
     assert(value == 0 || value == 1 || value == DontCare);
 
-    switch (index % 4)
+    word_pair& word         = words_[as_uindex(index / 64)];
+    std::uint64_t const bit = std::uint64_t {1} << (index % 64);
+    if (value == DontCare)
+    {
+        word.care_ &= ~bit;
+    }
+    else
+    {
+        word.care_ |= bit;
+    }
+
+    if (value == 1)
+    {
+        word.value_ |= bit;
+    }
+    else
+    {
+        word.value_ &= ~bit;
+    }
+}
+
+inline auto bool_cube::contains(bool_cube const& other) const -> bool
+{
+    assert(size_ == other.size_);
+
+    std::uint64_t missing = 0;
+    for (std::size_t i = 0; i < words_.size(); ++i)
+    {
+        word_pair const lhs  = words_[i];
+        word_pair const rhs  = other.words_[i];
+        missing             |= (lhs.care_ & ~rhs.care_) | conflicts(lhs, rhs);
+    }
+    return missing == 0;
+}
+
+inline auto bool_cube::intersects(bool_cube const& other) const -> bool
+{
+    assert(size_ == other.size_);
+
+    std::uint64_t conflict = 0;
+    for (std::size_t i = 0; i < words_.size(); ++i)
     {
-    case 0:
-        values_[uByteIndex].b0 = value & 0b11;
-        break;
-    case 1:
-        values_[uByteIndex].b1 = value & 0b11;
-        break;
-    case 2:
-        values_[uByteIndex].b2 = value & 0b11;
-        break;
-    case 3:
-        values_[uByteIndex].b3 = value & 0b11;
-        break;
+        conflict |= conflicts(words_[i], other.words_[i]);
     }
+    return conflict == 0;
+}
+
+inline auto bool_cube::intersection(bool_cube const& other) const
+    -> std::optional<bool_cube>
+{
+    if (not this->intersects(other))
+    {
+        return std::nullopt;
+    }
+
+    bool_cube result = *this;
+    for (std::size_t i = 0; i < words_.size(); ++i)
+    {
+        result.words_[i].care_  |= other.words_[i].care_;
+        result.words_[i].value_ |= other.words_[i].value_;
+    }
+    return result;
+}
+
+inline auto bool_cube::distance(bool_cube const& other) const -> int32
+{
+    assert(size_ == other.size_);
+
+    int32 result = 0;
+    for (std::size_t i = 0; i < words_.size(); ++i)
+    {
+        result += std::popcount(conflicts(words_[i], other.words_[i]));
+    }
+    return result;
+}
+
+inline auto bool_cube::conflicts(word_pair const lhs, word_pair const rhs)
+    -> std::uint64_t
+{
+    return lhs.care_ & rhs.care_ & (lhs.value_ ^ rhs.value_);
 }
 
 // pla_file definitions:
@@ -208,209 +363,236 @@ inline auto bool_cube::set(int32 const index, int32 const value) -> void
 inline auto pla_file::load_file(std::string const& path)
     -> std::optional<pla_file>
 {
-    auto constexpr to_words = [] (std::string const& str)
-    {
-        std::vector<std::string> words;
-        auto strIt       = str.begin();
-        auto const endIt = str.end();
+#ifdef LIBTEDDY_COLLECT_STATS
+    stats::tick(stats::get_stats().plaParse_);
+#endif
 
-        while (strIt != endIt)
-        {
-            auto const wordBegin = utils::find_if_not(strIt, endIt, ::isspace);
-            auto const wordEnd   = utils::find_if(wordBegin, endIt, ::isspace);
-            if (wordBegin != wordEnd)
-            {
-                words.emplace_back(wordBegin, wordEnd);
-            }
-            strIt = wordEnd;
-        }
+    std::optional<pla_file> file = load_file_impl(path);
 
-        return words;
-    };
+#ifdef LIBTEDDY_COLLECT_STATS
+    stats::tock(stats::get_stats().plaParse_);
+#endif
+
+    return file;
+}
 
-    auto ifst = std::ifstream(path);
-    if (not ifst.is_open())
+template<class LineOp>
+auto pla_file::scan_file(std::string const& path, LineOp lineOp)
+    -> std::optional<pla_header>
+{
+    line_reader reader(path);
+    if (not reader.is_open())
     {
         return std::nullopt;
     }
 
+    std::string_view line;
+
     // Read options.
-    auto options = std::unordered_map<std::string, std::string>();
-    auto line    = std::string();
-    while (std::getline(ifst, line))
+    std::optional<int32> varCount;
+    std::optional<int32> fCount;
+    std::optional<int64> lineCount;
+    std::vector<std::string> inputLabels;
+    std::vector<std::string> outputLabels;
+    bool isData = false;
+    while (reader.next_line(line))
     {
-        // Skip leading spaces.
-        auto const first
-            = utils::find_if_not(line.begin(), line.end(), ::isspace);
-        auto const last = line.end();
-        if (first == last)
+        line = pla_file::trim(line);
+        if (line.empty() || line.front() == '#')
         {
-            // Skip empty line.
+            // Skip empty line or comment.
             continue;
         }
 
-        if (*first == '#')
-        {
-            // Skip comment.
-            continue;
-        }
-
-        if (*first != '.')
+        if (line.front() != '.')
         {
             // Not an option.
+            isData = true;
             break;
         }
 
         // Split into (key, val) pair on the first space.
-        auto const keyLast = utils::find_if(first, last, ::isspace);
-        auto const valFirst
-            = keyLast == last
-                ? last
-                : utils::find_if_not(keyLast + 1, last, ::isspace);
-        std::string key(first, keyLast);
-        if (valFirst != last)
+        std::size_t const keyLast = pla_file::find_space(line, 0);
+        std::string_view const key   = line.substr(0, keyLast);
+        std::string_view const value = pla_file::trim(line.substr(keyLast));
+        if (key == ".i")
         {
-            auto valLast = last;
-            while (::isspace(*(valLast - 1)))
-            {
-                --valLast;
-            }
-            std::string val(valFirst, valLast);
-            options.emplace(
-                static_cast<std::string&&>(key),
-                static_cast<std::string&&>(val)
-            );
+            varCount = utils::parse<int32>(value);
         }
-        else
+        else if (key == ".o")
         {
-            options.emplace(static_cast<std::string&&>(key), std::string());
+            fCount = utils::parse<int32>(value);
         }
-    }
-
-    // Parse header.
-    auto const optionsEnd  = options.end();
-    auto const varCountIt  = options.find(".i");
-    auto const fCountIt    = options.find(".o");
-    auto const lineCountIt = options.find(".p");
-    if (varCountIt == optionsEnd || fCountIt == optionsEnd
-        || lineCountIt == optionsEnd)
-    {
-        return std::nullopt;
-    }
-
-    std::optional<int32> varCount  = utils::parse<int32>(varCountIt->second);
-    std::optional<int32> fCount    = utils::parse<int32>(fCountIt->second);
-    std::optional<int32> lineCount = utils::parse<int64>(lineCountIt->second);
-
-    if (not varCount || not fCount || not lineCount)
-    {
-        return std::nullopt;
-    }
-
-    // Read data.
-    std::vector<pla_file::pla_line> lines;
-    lines.reserve(as_usize(*lineCount));
-    do
-    {
-        auto const first
-            = utils::find_if_not(line.begin(), line.end(), ::isspace);
-        auto const last = line.end();
-        if (first == last)
+        else if (key == ".p")
         {
-            // Skip empty line.
-            continue;
+            lineCount = utils::parse<int64>(value);
         }
-
-        if (*first == '.')
+        else if (key == ".ilb")
         {
-            // This can only be the .e line.
-            break;
+            inputLabels = pla_file::to_words(value);
         }
-
-        // Split on the first space.
-        auto const varsLast = utils::find_if(first, last, ::isspace);
-        if (varsLast == last)
+        else if (key == ".ob")
         {
-            return std::nullopt;
+            outputLabels = pla_file::to_words(value);
         }
-        auto const fsFirst = utils::find_if_not(varsLast + 1, last, ::isspace);
-        auto const fsLast  = utils::find_if(fsFirst, last, ::isspace);
-        std::string const varsStr(first, varsLast);
-        std::string const fStr(fsFirst, fsLast);
+    }
 
-        if (ssize(varsStr) != *varCount || ssize(fStr) != *fCount)
-        {
-            return std::nullopt;
-        }
+    if (not varCount || not fCount || not lineCount)
+    {
+        return std::nullopt;
+    }
 
-        // Parse variables into cube.
-        bool_cube variables(*varCount);
-        for (auto i = 0; i < *varCount; ++i)
+    // Read data, each line is parsed in place and passed to the callback.
+    pla_line cubeLine {bool_cube(*varCount), bool_cube(*fCount)};
+    while (isData)
+    {
+        if (not line.empty() && line.front() != '#')
         {
-            switch (varsStr[as_uindex(i)])
+            if (line.front() == '.')
             {
-            case '0':
-                variables.set(i, 0);
+                // This can only be the .e line.
                 break;
-            case '1':
-                variables.set(i, 1);
-                break;
-            case '~':
-            case '-':
-                variables.set(i, bool_cube::DontCare);
-                break;
-            default:
-                return std::nullopt;
             }
-        }
 
-        // Parse functions into cube.
-        bool_cube functions(*fCount);
-        for (auto i = 0; i < *fCount; ++i)
-        {
-            switch (fStr[as_uindex(i)])
+            // Split on the first space.
+            std::size_t const varsLast = pla_file::find_space(line, 0);
+            if (varsLast == line.size())
             {
-            case '0':
-                functions.set(i, 0);
-                break;
-            case '1':
-                functions.set(i, 1);
-                break;
-            case '-':
-            case '~':
-                functions.set(i, bool_cube::DontCare);
-                break;
-            default:
                 return std::nullopt;
             }
+            std::string_view const fsRest
+                = pla_file::trim(line.substr(varsLast));
+            std::string_view const varsStr = line.substr(0, varsLast);
+            std::string_view const fStr
+                = fsRest.substr(0, pla_file::find_space(fsRest, 0));
+
+            if (not pla_file::parse_cube(varsStr, cubeLine.cube_)
+                || not pla_file::parse_cube(fStr, cubeLine.fVals_))
+            {
+                return std::nullopt;
+            }
+
+            lineOp(static_cast<pla_line const&>(cubeLine));
         }
 
-        lines.push_back(pla_file::pla_line {variables, functions});
+        isData = reader.next_line(line);
+        if (isData)
+        {
+            line = pla_file::trim(line);
+        }
+    }
 
-    } while (std::getline(ifst, line));
+    return pla_header {
+        *varCount,
+        *fCount,
+        *lineCount,
+        static_cast<std::vector<std::string>&&>(inputLabels),
+        static_cast<std::vector<std::string>&&>(outputLabels)
+    };
+}
 
-    // Read labels.
-    auto const inLbIt = options.find(".ilb");
-    auto const ouLbIt = options.find(".ob");
-    std::vector<std::string> inputLabels;
-    if (inLbIt != options.end())
-    {
-        inputLabels = to_words(inLbIt->second);
-    }
+inline auto pla_file::load_file_impl(std::string const& path)
+    -> std::optional<pla_file>
+{
+    std::vector<pla_file::pla_line> lines;
+    std::optional<pla_header> header = pla_file::scan_file(
+        path,
+        [&lines] (pla_line const& line) { lines.push_back(line); }
+    );
 
-    std::vector<std::string> outputLabels;
-    if (ouLbIt != options.end())
+    if (not header)
     {
-        outputLabels = to_words(ouLbIt->second);
+        return std::nullopt;
     }
 
     return pla_file(
         static_cast<std::vector<pla_file::pla_line>&&>(lines),
-        static_cast<std::vector<std::string>&&>(inputLabels),
-        static_cast<std::vector<std::string>&&>(outputLabels)
+        static_cast<std::vector<std::string>&&>(header->inputLabels_),
+        static_cast<std::vector<std::string>&&>(header->outputLabels_)
     );
 }
 
+inline auto pla_file::is_space(char const character) -> bool
+{
+    return character == ' ' || character == '\t' || character == '\r'
+        || character == '\n' || character == '\v' || character == '\f';
+}
+
+inline auto pla_file::find_space(
+    std::string_view const str,
+    std::size_t position
+) -> std::size_t
+{
+    while (position < str.size() && not pla_file::is_space(str[position]))
+    {
+        ++position;
+    }
+    return position;
+}
+
+inline auto pla_file::trim(std::string_view str) -> std::string_view
+{
+    while (not str.empty() && pla_file::is_space(str.front()))
+    {
+        str.remove_prefix(1);
+    }
+    while (not str.empty() && pla_file::is_space(str.back()))
+    {
+        str.remove_suffix(1);
+    }
+    return str;
+}
+
+inline auto pla_file::to_words(std::string_view const str)
+    -> std::vector<std::string>
+{
+    std::vector<std::string> words;
+    std::size_t position = 0;
+    while (position < str.size())
+    {
+        while (position < str.size() && pla_file::is_space(str[position]))
+        {
+            ++position;
+        }
+        std::size_t const wordEnd = pla_file::find_space(str, position);
+        if (wordEnd != position)
+        {
+            words.emplace_back(str.substr(position, wordEnd - position));
+        }
+        position = wordEnd;
+    }
+    return words;
+}
+
+inline auto pla_file::parse_cube(std::string_view const str, bool_cube& cube)
+    -> bool
+{
+    if (ssize(str) != cube.size())
+    {
+        return false;
+    }
+
+    for (int32 i = 0; i < cube.size(); ++i)
+    {
+        switch (str[as_uindex(i)])
+        {
+        case '0':
+            cube.set(i, 0);
+            break;
+        case '1':
+            cube.set(i, 1);
+            break;
+        case '-':
+        case '~':
+            cube.set(i, bool_cube::DontCare);
+            break;
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
 inline pla_file::pla_file(
     std::vector<pla_line> lines,
     std::vector<std::string> inputLabels,
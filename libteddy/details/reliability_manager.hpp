@@ -115,6 +115,113 @@ public:
         diagram_t const& diagram
     ) -> double;
 
+    /**
+     *  \brief Calculates and returns probabilities of system states 0 and 1
+     *
+     *  \p probs[i] must return probability that i-th component is in state 1
+     *
+     *  \tparam Type that holds component state probabilities
+     *  \param probs vector of component state probabilities
+     *  \param diagram Structure function
+     *  \return Vector where i-th element is probability of system state i
+     */
+    template<probs::prob_vector Ps>
+    requires(details::is_bss<Degree>)
+    auto calculate_state_probabilities (
+        Ps const& probs,
+        diagram_t const& diagram
+    ) -> std::vector<double>;
+
+    /**
+     *  \brief Calculates and returns probabilities of all system states
+     *
+     *  \p probs[i][k] must return probability that i-th component is in state k
+     *  Unlike \c calculate_probabilities, this method does not store
+     *  probabilities in the terminal nodes. All states are calculated
+     *  in a single bottom-up traversal.
+     *
+     *  \tparam Type that holds component state probabilities
+     *  \param probs matrix of component state probabilities
+     *  \param diagram Structure function
+     *  \return Vector where i-th element is probability of system state i
+     */
+    template<probs::prob_matrix Ps>
+    auto calculate_state_probabilities (
+        Ps const& probs,
+        diagram_t const& diagram
+    ) -> std::vector<double>;
+
+    /**
+     *  \brief Calculates and returns probabilities of all system states
+     *  for each of \p diagrams
+     *
+     *  \p probs[i][k] must return probability that i-th component is in state k
+     *  All diagrams are processed in a single traversal of the union
+     *  of their nodes so that shared subdiagrams are processed only once.
+     *
+     *  \tparam Type that holds component state probabilities
+     *  \param probs matrix of component state probabilities
+     *  \param diagrams Structure functions
+     *  \return Vector where i-th element is the result of
+     *  \c calculate_state_probabilities for the i-th diagram
+     */
+    template<probs::prob_matrix Ps>
+    auto calculate_state_probabilities (
+        Ps const& probs,
+        std::vector<diagram_t> const& diagrams
+    ) -> std::vector<std::vector<double>>;
+
+    /**
+     *  \brief Calculates and returns system availability with
+     *  respect to the system state \p state for each of \p diagrams
+     *
+     *  \p probs[i][k] must return probability that i-th component is in state k
+     *  All diagrams are processed in a single traversal of the union
+     *  of their nodes so that shared subdiagrams are processed only once.
+     *
+     *  \tparam Type that holds component state probabilities
+     *  \param state System state
+     *  \param probs matrix of component state probabilities
+     *  \param diagrams Structure functions
+     *  \return Vector where i-th element is availability of the system
+     *  described by the i-th diagram
+     */
+    template<probs::prob_matrix Ps>
+    auto calculate_availabilities (
+        int32 state,
+        Ps const& probs,
+        std::vector<diagram_t> const& diagrams
+    ) -> std::vector<double>;
+
+    using diagram_manager<double, Degree, Domain>::sample_satisfying;
+
+    /**
+     *  \brief Draws random component states for which the system
+     *  is in state \p state
+     *
+     *  \p probs[i][k] must return probability that i-th component is in state k
+     *  Component states are drawn from the conditional distribution given
+     *  the system state, i.e., more probable states are drawn more often.
+     *  Probabilities are calculated once for all \p count samples.
+     *
+     *  \tparam Type that holds component state probabilities
+     *  \param state System state
+     *  \param probs matrix of component state probabilities
+     *  \param diagram Structure function
+     *  \param rng Uniform random bit generator
+     *  \param count Number of samples
+     *  \return Vector of \p count component state vectors or empty vector
+     *  if the system state has zero probability
+     */
+    template<probs::prob_matrix Ps, class Rng>
+    auto sample_satisfying (
+        int32 state,
+        Ps const& probs,
+        diagram_t const& diagram,
+        Rng& rng,
+        int64 count
+    ) -> std::vector<std::vector<int32>>;
+
     /**
      *  \brief Returns probability of given system state.
      *
@@ -197,6 +304,53 @@ public:
      */
     [[nodiscard]] auto get_availability (int32 state) const -> double;
 
+    /**
+     *  \brief Calculates availability of a BSS at each time point
+     *  in \p times
+     *
+     *  \p dists[i] must return distribution of probability that i-th
+     *  component is in state 1. Distributions are only evaluated,
+     *  never modified. See the overload for MSS for details.
+     *
+     *  \tparam Ps Vector of component state distributions
+     *  \param dists vector of component state distributions
+     *  \param diagram Structure function
+     *  \param times Time points
+     *  \return Vector where i-th element is availability at times[i]
+     */
+    template<probs::dist_vector Ps>
+    requires(details::is_bss<Degree>)
+    auto calculate_availability_curve (
+        Ps const& dists,
+        diagram_t const& diagram,
+        std::vector<double> const& times
+    ) -> std::vector<double>;
+
+    /**
+     *  \brief Calculates system availability with respect to the system
+     *  state \p state at each time point in \p times
+     *
+     *  \p dists[i][k] must return distribution of probability that i-th
+     *  component is in state k. Unlike calling \c calculate_availability
+     *  after \c probs::at_time for each time point, the diagram is
+     *  traversed only once. Each node then holds values for a block of
+     *  time points that are calculated together in tight loops.
+     *
+     *  \tparam Ps Matrix of component state distributions
+     *  \param state System state
+     *  \param dists matrix of component state distributions
+     *  \param diagram Structure function
+     *  \param times Time points
+     *  \return Vector where i-th element is availability at times[i]
+     */
+    template<probs::dist_matrix Ps>
+    auto calculate_availability_curve (
+        int32 state,
+        Ps const& dists,
+        diagram_t const& diagram,
+        std::vector<double> const& times
+    ) -> std::vector<double>;
+
     /**
      *  \brief Calculates and returns unavailability of a BSS
      *
@@ -374,6 +528,47 @@ public:
         int32 componentIndex
     ) -> double;
 
+    /**
+     *  \brief Calculates Structural Importances of all components
+     *
+     *  Same as \c structural_importance with a DPLD of type 3 decrease
+     *  for each component and each change of its state from \c k to
+     *  \c k-1 . All importances are calculated from a single bottom-up
+     *  and a single top-down traversal of the structure function instead
+     *  of calculating one DPLD per component and state.
+     *  The structure function must be monotone (coherent system).
+     *
+     *  \param state System state
+     *  \param diagram Structure function
+     *  \return Matrix where element at [i][k] is the importance of
+     *  change of the i-th component from state k to k-1 ([i][0] is 0)
+     */
+    auto structural_importances (int32 state, diagram_t const& diagram)
+        -> std::vector<std::vector<double>>;
+
+    /**
+     *  \brief Calculates Birnbaum importances of all components
+     *
+     *  Same as \c birnbaum_importance with a DPLD of type 3 decrease
+     *  for each component and each change of its state from \c k to
+     *  \c k-1 . All importances are calculated from a single bottom-up
+     *  and a single top-down traversal of the structure function instead
+     *  of calculating one DPLD per component and state.
+     *  The structure function must be monotone (coherent system).
+     *
+     *  \param state System state
+     *  \param probs Component state probabilities
+     *  \param diagram Structure function
+     *  \return Matrix where element at [i][k] is the importance of
+     *  change of the i-th component from state k to k-1 ([i][0] is 0)
+     */
+    template<probs::prob_matrix Ps>
+    auto birnbaum_importances (
+        int32 state,
+        Ps const& probs,
+        diagram_t const& diagram
+    ) -> std::vector<std::vector<double>>;
+
     /**
      *  \brief Finds all Minimal Cut Vector (MCVs) of the system with
      *  respect to the system state \p State
@@ -462,61 +657,22 @@ private:
     using node_t = typename diagram_manager<double, Degree, Domain>::node_t;
     using son_conainer = typename node_t::son_container;
 
-    // TODO not nice
-    // same problem as n-ary apply, we will see...
-
-    struct dpld_cache_entry
-    {
-        node_t* lhs_;
-        node_t* rhs_;
-    };
-
-    struct cache_entry_hash
-    {
-        auto operator() (dpld_cache_entry const& entry) const
-        {
-            return utils::pack_hash(entry.lhs_, entry.rhs_);
-        }
-    };
-
-    struct cache_entry_equals
-    {
-        auto operator() (
-            dpld_cache_entry const& lhs,
-            dpld_cache_entry const& rhs
-        ) const
-        {
-            return lhs.lhs_ == rhs.lhs_ && lhs.rhs_ == rhs.rhs_;
-        }
-    };
-
-    using dpld_cache = std::unordered_map<
-        dpld_cache_entry,
-        node_t*,
-        cache_entry_hash,
-        cache_entry_equals>;
-
 private:
     auto to_mnf (diagram_t const& diagram) -> diagram_t;
 
-    auto to_mnf_impl (std::unordered_map<node_t*, node_t*>& memo, node_t* node)
-        -> node_t*;
+    auto to_mnf_impl (node_t* node) -> node_t*;
 
     template<class FChange>
     auto dpld_impl (
-        dpld_cache& cache,
+        int32 opId,
         var_change varChange,
         FChange fChange,
         node_t* lhs,
         node_t* rhs
     ) -> node_t*;
 
-    auto to_dpld_e_impl (
-        std::unordered_map<node_t*, node_t*>& memo,
-        int32 varFrom,
-        int32 varIndex,
-        node_t* node
-    ) -> node_t*;
+    auto to_dpld_e_impl (int32 varFrom, int32 varIndex, node_t* node)
+        -> node_t*;
 
     template<probs::prob_matrix Ps>
     auto calculate_ntps_post_impl (
@@ -527,6 +683,18 @@ private:
 
     template<probs::prob_matrix Ps>
     auto calculate_ntps_level_impl (Ps const& probs, node_t* root) -> void;
+
+    template<class VarProb>
+    auto importances_impl (int32 state, node_t* root, VarProb varProb)
+        -> std::vector<std::vector<double>>;
+
+    template<class VarProb>
+    auto availability_curve_impl (
+        int32 state,
+        node_t* root,
+        std::vector<double> const& times,
+        VarProb varProb
+    ) -> std::vector<double>;
 };
 
 template<class Degree, class Domain>
@@ -580,6 +748,98 @@ auto reliability_manager<Degree, Domain>::calculate_probability(
         ->calculate_ntps_post_impl({state}, probs, diagram.unsafe_get_root());
 }
 
+template<class Degree, class Domain>
+template<probs::prob_vector Ps>
+requires(details::is_bss<Degree>)
+auto reliability_manager<Degree, Domain>::calculate_state_probabilities(
+    Ps const& probs,
+    diagram_t const& diagram
+) -> std::vector<double>
+{
+    return this->calculate_state_probabilities(
+        probs::details::prob_vector_wrap(probs),
+        diagram
+    );
+}
+
+template<class Degree, class Domain>
+template<probs::prob_matrix Ps>
+auto reliability_manager<Degree, Domain>::calculate_state_probabilities(
+    Ps const& probs,
+    diagram_t const& diagram
+) -> std::vector<double>
+{
+    return this->template terminal_weights<double>(
+        diagram.unsafe_get_root(),
+        [&probs] (node_t* const node, node_t*, int32 const k)
+        { return probs[as_uindex(node->get_index())][as_uindex(k)]; }
+    );
+}
+
+template<class Degree, class Domain>
+template<probs::prob_matrix Ps>
+auto reliability_manager<Degree, Domain>::calculate_state_probabilities(
+    Ps const& probs,
+    std::vector<diagram_t> const& diagrams
+) -> std::vector<std::vector<double>>
+{
+    std::vector<node_t*> roots;
+    roots.reserve(diagrams.size());
+    for (diagram_t const& diagram : diagrams)
+    {
+        roots.push_back(diagram.unsafe_get_root());
+    }
+
+    return this->template terminal_weights<double>(
+        roots,
+        [&probs] (node_t* const node, node_t*, int32 const k)
+        { return probs[as_uindex(node->get_index())][as_uindex(k)]; }
+    );
+}
+
+template<class Degree, class Domain>
+template<probs::prob_matrix Ps>
+auto reliability_manager<Degree, Domain>::calculate_availabilities(
+    int32 const state,
+    Ps const& probs,
+    std::vector<diagram_t> const& diagrams
+) -> std::vector<double>
+{
+    std::vector<double> availabilities;
+    availabilities.reserve(diagrams.size());
+    for (std::vector<double> const& stateProbs :
+         this->calculate_state_probabilities(probs, diagrams))
+    {
+        double availability = 0.0;
+        for (int32 j = state; j < ssize(stateProbs); ++j)
+        {
+            availability += stateProbs[as_uindex(j)];
+        }
+        availabilities.push_back(availability);
+    }
+    return availabilities;
+}
+
+template<class Degree, class Domain>
+template<probs::prob_matrix Ps, class Rng>
+auto reliability_manager<Degree, Domain>::sample_satisfying(
+    int32 const state,
+    Ps const& probs,
+    diagram_t const& diagram,
+    Rng& rng,
+    int64 const count
+) -> std::vector<std::vector<int32>>
+{
+    return this->sample_satisfying_impl(
+        state,
+        diagram.unsafe_get_root(),
+        rng,
+        count,
+        [&probs] (int32 const index, int32 const k) -> double
+        { return probs[as_uindex(index)][as_uindex(k)]; }
+    );
+}
+
 template<class Degree, class Domain>
 auto reliability_manager<Degree, Domain>::get_probability(int32 const state
 ) const -> double
@@ -652,6 +912,45 @@ auto reliability_manager<Degree, Domain>::get_availability(int32 const state
     return result;
 }
 
+template<class Degree, class Domain>
+template<probs::dist_vector Ps>
+requires(details::is_bss<Degree>)
+auto reliability_manager<Degree, Domain>::calculate_availability_curve(
+    Ps const& dists,
+    diagram_t const& diagram,
+    std::vector<double> const& times
+) -> std::vector<double>
+{
+    return this->availability_curve_impl(
+        1,
+        diagram.unsafe_get_root(),
+        times,
+        [&dists] (int32 const index, int32 const k, double const t)
+        {
+            double const prob = dists[as_uindex(index)](t);
+            return k == 1 ? prob : 1 - prob;
+        }
+    );
+}
+
+template<class Degree, class Domain>
+template<probs::dist_matrix Ps>
+auto reliability_manager<Degree, Domain>::calculate_availability_curve(
+    int32 const state,
+    Ps const& dists,
+    diagram_t const& diagram,
+    std::vector<double> const& times
+) -> std::vector<double>
+{
+    return this->availability_curve_impl(
+        state,
+        diagram.unsafe_get_root(),
+        times,
+        [&dists] (int32 const index, int32 const k, double const t)
+        { return dists[as_uindex(index)][as_uindex(k)](t); }
+    );
+}
+
 template<class Degree, class Domain>
 template<probs::prob_matrix Ps, class Foo>
 requires(details::is_bss<Degree>)
@@ -774,7 +1073,7 @@ auto reliability_manager<Degree, Domain>::state_frequency(
     int32 const indexFrom  = 0;
     int32 const indexTo    = this->get_var_count();
     int64 const domainSize = this->nodes_.domain_product(indexFrom, indexTo);
-    return static_cast<double>(this->satisfy_count(state, diagram))
+    return this->template satisfy_count<double>(state, diagram)
          / static_cast<double>(domainSize);
 }
 
@@ -786,8 +1085,8 @@ auto reliability_manager<Degree, Domain>::dpld(
     diagram_t const& diagram
 ) -> diagram_t
 {
-    // TODO vector cache?
-    dpld_cache cache;
+    // Result depends on the function object, the id is unique for each call.
+    int32 const opId      = this->nodes_.make_operation_id();
     node_t* const oldRoot = diagram.unsafe_get_root();
     node_t* lhsRoot       = oldRoot;
     node_t* rhsRoot       = oldRoot;
@@ -797,7 +1096,7 @@ auto reliability_manager<Degree, Domain>::dpld(
         rhsRoot = oldRoot->get_son(varChange.to_);
     }
     node_t* const newRoot
-        = this->dpld_impl(cache, varChange, fChange, lhsRoot, rhsRoot);
+        = this->dpld_impl(opId, varChange, fChange, lhsRoot, rhsRoot);
     this->nodes_.run_deferred();
     return diagram_t(newRoot);
 }
@@ -805,7 +1104,7 @@ auto reliability_manager<Degree, Domain>::dpld(
 template<class Degree, class Domain>
 template<class FChange>
 auto reliability_manager<Degree, Domain>::dpld_impl(
-    dpld_cache& cache,
+    int32 const opId,
     var_change varChange,
     FChange fChange,
     node_t* const lhs,
@@ -823,10 +1122,10 @@ auto reliability_manager<Degree, Domain>::dpld_impl(
                  : son;
     };
 
-    auto const cached = cache.find(dpld_cache_entry(lhs, rhs));
-    if (cached != cache.end())
+    node_t* const cached = this->nodes_.computed_find(opId, lhs, rhs, 0, 0);
+    if (cached)
     {
-        return cached->second;
+        return cached;
     }
 
     node_t* result = nullptr;
@@ -856,13 +1155,13 @@ auto reliability_manager<Degree, Domain>::dpld_impl(
                 = rhsLevel == topLevel
                     ? get_son(rhs, k, varChange.index_, varChange.to_)
                     : rhs;
-            sons[k] = this->dpld_impl(cache, varChange, fChange, fst, snd);
+            sons[k] = this->dpld_impl(opId, varChange, fChange, fst, snd);
         }
 
         result = this->nodes_.make_internal_node(topIndex, sons);
     }
 
-    cache.emplace(dpld_cache_entry(lhs, rhs), result);
+    this->nodes_.computed_put(opId, result, lhs, rhs, 0, 0);
 
     return result;
 }
@@ -893,8 +1192,7 @@ auto reliability_manager<Degree, Domain>::to_dpld_e(
     }
     else
     {
-        std::unordered_map<node_t*, node_t*> memo;
-        newRoot = this->to_dpld_e_impl(memo, varFrom, varIndex, root);
+        newRoot = this->to_dpld_e_impl(varFrom, varIndex, root);
     }
 
     // TODO run at other places too
@@ -905,7 +1203,6 @@ auto reliability_manager<Degree, Domain>::to_dpld_e(
 
 template<class Degree, class Domain>
 auto reliability_manager<Degree, Domain>::to_dpld_e_impl(
-    std::unordered_map<node_t*, node_t*>& memo,
     int32 const varFrom,
     int32 const varIndex,
     node_t* const node
@@ -916,10 +1213,16 @@ auto reliability_manager<Degree, Domain>::to_dpld_e_impl(
         return node;
     }
 
-    auto const memoIt = memo.find(node);
-    if (memoIt != memo.end())
+    node_t* const cached = this->nodes_.computed_find(
+        this->TO_DPLD_E_OP_ID,
+        node,
+        nullptr,
+        varFrom,
+        varIndex
+    );
+    if (cached)
     {
-        return memoIt->second;
+        return cached;
     }
 
     int32 const varDomain  = this->nodes_.get_domain(varIndex);
@@ -948,11 +1251,18 @@ auto reliability_manager<Degree, Domain>::to_dpld_e_impl(
         else
         {
             // A new node will be inserted somewhere deeper.
-            sons[k] = this->to_dpld_e_impl(memo, varFrom, varIndex, son);
+            sons[k] = this->to_dpld_e_impl(varFrom, varIndex, son);
         }
     }
     node_t* const newNode = this->nodes_.make_internal_node(nodeIndex, sons);
-    memo.emplace(node, newNode);
+    this->nodes_.computed_put(
+        this->TO_DPLD_E_OP_ID,
+        newNode,
+        node,
+        nullptr,
+        varFrom,
+        varIndex
+    );
     return newNode;
 }
 
@@ -964,7 +1274,7 @@ auto reliability_manager<Degree, Domain>::structural_importance(
     int32 const indexFrom  = 0;
     int32 const indexTo    = this->get_var_count();
     int64 const domainSize = this->nodes_.domain_product(indexFrom, indexTo);
-    return static_cast<double>(this->satisfy_count(1, dpld))
+    return this->template satisfy_count<double>(1, dpld)
          / static_cast<double>(domainSize);
 }
 
@@ -999,6 +1309,36 @@ auto reliability_manager<Degree, Domain>::fussell_vesely_importance(
     return nominator / unavailability;
 }
 
+template<class Degree, class Domain>
+auto reliability_manager<Degree, Domain>::structural_importances(
+    int32 const state,
+    diagram_t const& diagram
+) -> std::vector<std::vector<double>>
+{
+    return this->importances_impl(
+        state,
+        diagram.unsafe_get_root(),
+        [this] (int32 const index, int32)
+        { return 1.0 / static_cast<double>(this->nodes_.get_domain(index)); }
+    );
+}
+
+template<class Degree, class Domain>
+template<probs::prob_matrix Ps>
+auto reliability_manager<Degree, Domain>::birnbaum_importances(
+    int32 const state,
+    Ps const& probs,
+    diagram_t const& diagram
+) -> std::vector<std::vector<double>>
+{
+    return this->importances_impl(
+        state,
+        diagram.unsafe_get_root(),
+        [&probs] (int32 const index, int32 const k) -> double
+        { return probs[as_uindex(index)][as_uindex(k)]; }
+    );
+}
+
 template<class Degree, class Domain>
 template<out_var_values Vars>
 auto reliability_manager<Degree, Domain>::mcvs(
@@ -1154,31 +1494,203 @@ auto reliability_manager<Degree, Domain>::calculate_ntps_level_impl(
     );
 }
 
+template<class Degree, class Domain>
+template<class VarProb>
+auto reliability_manager<Degree, Domain>::importances_impl(
+    int32 const state,
+    node_t* const root,
+    VarProb varProb
+) -> std::vector<std::vector<double>>
+{
+    // Bottom-up: probability that the system is in state >= state
+    // when the evaluation starts in a node.
+    std::vector<node_t*> order;
+    std::vector<double> availabilities;
+    this->nodes_.traverse_post_numbered(
+        root,
+        [this, state, &order, &availabilities, &varProb] (node_t* const node)
+        {
+            order.push_back(node);
+            if (node->is_terminal())
+            {
+                bool const isAvailable = node->get_value() >= state;
+                availabilities.push_back(isAvailable ? 1.0 : 0.0);
+                return;
+            }
+
+            double availability    = 0.0;
+            int32 const nodeIndex  = node->get_index();
+            int32 const nodeDomain = this->nodes_.get_domain(nodeIndex);
+            for (int32 k = 0; k < nodeDomain; ++k)
+            {
+                auto const sonId = as_uindex(node->get_son(k)->get_scratch());
+                availability += varProb(nodeIndex, k) * availabilities[sonId];
+            }
+            availabilities.push_back(availability);
+        }
+    );
+
+    // Top-down: probability of reaching a node. Reversed post-order
+    // visits each node after all of its parents.
+    std::vector<double> reachProbs(order.size(), 0.0);
+    reachProbs[as_uindex(root->get_scratch())] = 1.0;
+    std::vector<std::vector<double>> importances;
+    for (int32 index = 0; index < this->get_var_count(); ++index)
+    {
+        importances.emplace_back(as_usize(this->nodes_.get_domain(index)));
+    }
+
+    for (auto it = order.rbegin(); it != order.rend(); ++it)
+    {
+        node_t* const node = *it;
+        if (node->is_terminal())
+        {
+            continue;
+        }
+
+        // For a monotone function, the change from k to k-1 breaks
+        // the system exactly when son k works and son k-1 does not.
+        double const reachProb = reachProbs[as_uindex(node->get_scratch())];
+        int32 const nodeIndex  = node->get_index();
+        int32 const nodeDomain = this->nodes_.get_domain(nodeIndex);
+        auto& nodeImportances  = importances[as_uindex(nodeIndex)];
+        for (int32 k = 0; k < nodeDomain; ++k)
+        {
+            auto const sonId = as_uindex(node->get_son(k)->get_scratch());
+            reachProbs[sonId] += reachProb * varProb(nodeIndex, k);
+            if (k > 0)
+            {
+                auto const prevId
+                    = as_uindex(node->get_son(k - 1)->get_scratch());
+                nodeImportances[as_uindex(k)]
+                    += reachProb
+                     * (availabilities[sonId] - availabilities[prevId]);
+            }
+        }
+    }
+    return importances;
+}
+
+template<class Degree, class Domain>
+template<class VarProb>
+auto reliability_manager<Degree, Domain>::availability_curve_impl(
+    int32 const state,
+    node_t* const root,
+    std::vector<double> const& times,
+    VarProb varProb
+) -> std::vector<double>
+{
+    // Time points are processed in blocks so that memory needed for
+    // per-node values does not grow with the number of time points.
+    std::size_t constexpr BlockSize = 64;
+
+    std::vector<node_t*> order;
+    this->nodes_.traverse_post_numbered(
+        root,
+        [&order] (node_t* const node) { order.push_back(node); }
+    );
+
+    // Row of the probability table for each variable.
+    int32 const varCount = this->get_var_count();
+    std::vector<std::size_t> rowOffsets(as_usize(varCount));
+    std::size_t rowCount = 0;
+    for (int32 index = 0; index < varCount; ++index)
+    {
+        int32 const domain            = this->nodes_.get_domain(index);
+        rowOffsets[as_uindex(index)]  = rowCount;
+        rowCount                     += as_usize(domain);
+    }
+
+    std::vector<double> curve;
+    std::vector<double> probTable;
+    std::vector<double> values;
+    curve.reserve(times.size());
+    for (std::size_t first = 0; first < times.size(); first += BlockSize)
+    {
+        std::size_t const blockSize
+            = utils::min(BlockSize, times.size() - first);
+
+        // Distributions are evaluated once per variable, not per node.
+        probTable.assign(rowCount * blockSize, 0.0);
+        for (int32 index = 0; index < varCount; ++index)
+        {
+            int32 const domain = this->nodes_.get_domain(index);
+            for (int32 k = 0; k < domain; ++k)
+            {
+                std::size_t const row = rowOffsets[as_uindex(index)]
+                                      + as_usize(k);
+                for (std::size_t t = 0; t < blockSize; ++t)
+                {
+                    probTable[row * blockSize + t]
+                        = varProb(index, k, times[first + t]);
+                }
+            }
+        }
+
+        values.assign(order.size() * blockSize, 0.0);
+        for (node_t* const node : order)
+        {
+            std::size_t const base = as_usize(node->get_scratch()) * blockSize;
+            if (node->is_terminal())
+            {
+                double const value = node->get_value() >= state ? 1.0 : 0.0;
+                for (std::size_t t = 0; t < blockSize; ++t)
+                {
+                    values[base + t] = value;
+                }
+                continue;
+            }
+
+            int32 const nodeIndex  = node->get_index();
+            int32 const nodeDomain = this->nodes_.get_domain(nodeIndex);
+            for (int32 k = 0; k < nodeDomain; ++k)
+            {
+                node_t* const son = node->get_son(k);
+                std::size_t const sonBase
+                    = as_usize(son->get_scratch()) * blockSize;
+                std::size_t const probBase
+                    = (rowOffsets[as_uindex(nodeIndex)] + as_usize(k))
+                    * blockSize;
+                for (std::size_t t = 0; t < blockSize; ++t)
+                {
+                    values[base + t]
+                        += probTable[probBase + t] * values[sonBase + t];
+                }
+            }
+        }
+
+        std::size_t const rootBase = as_usize(root->get_scratch()) * blockSize;
+        for (std::size_t t = 0; t < blockSize; ++t)
+        {
+            curve.push_back(values[rootBase + t]);
+        }
+    }
+    return curve;
+}
+
 template<class Degree, class Domain>
 auto reliability_manager<Degree, Domain>::to_mnf(diagram_t const& diagram)
     -> diagram_t
 {
-    std::unordered_map<node_t*, node_t*> memo;
-    node_t* const newRoot = this->to_mnf_impl(memo, diagram.unsafe_get_root());
+    node_t* const newRoot = this->to_mnf_impl(diagram.unsafe_get_root());
     this->nodes_.run_deferred();
     return diagram_t(newRoot);
 }
 
 template<class Degree, class Domain>
-auto reliability_manager<Degree, Domain>::to_mnf_impl(
-    std::unordered_map<node_t*, node_t*>& memo,
-    node_t* node
-) -> node_t*
+auto reliability_manager<Degree, Domain>::to_mnf_impl(node_t* node)
+    -> node_t*
 {
     if (node->is_terminal())
     {
         return node;
     }
 
-    auto const memoIt = memo.find(node);
-    if (memoIt != memo.end())
+    node_t* const cached
+        = this->nodes_.computed_find(this->TO_MNF_OP_ID, node, nullptr, 0, 0);
+    if (cached)
     {
-        return memoIt->second;
+        return cached;
     }
 
     int32 const nodeIndex = node->get_index();
@@ -1187,7 +1699,7 @@ auto reliability_manager<Degree, Domain>::to_mnf_impl(
     for (int32 k = 0; k < domain; ++k)
     {
         node_t* const son = node->get_son(k);
-        sons[k]           = this->to_mnf_impl(memo, son);
+        sons[k]           = this->to_mnf_impl(son);
     }
 
     for (int32 k = domain - 1; k > 0; --k)
@@ -1213,7 +1725,7 @@ auto reliability_manager<Degree, Domain>::to_mnf_impl(
     }
 
     node_t* const newNode = this->nodes_.make_internal_node(nodeIndex, sons);
-    memo.emplace(node, newNode);
+    this->nodes_.computed_put(this->TO_MNF_OP_ID, newNode, node, nullptr, 0, 0);
     return newNode;
 }
 
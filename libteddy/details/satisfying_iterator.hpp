@@ -0,0 +1,366 @@
+#ifndef LIBTEDDY_DETAILS_SATISFYING_ITERATOR_HPP
+#define LIBTEDDY_DETAILS_SATISFYING_ITERATOR_HPP
+
+#include <libteddy/details/node_manager.hpp>
+#include <libteddy/details/types.hpp>
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace teddy
+{
+/**
+ *  \brief Value of a variable that does not affect the result of a cube
+ */
+inline constexpr int32 DontCare = -1;
+
+/**
+ *  \brief Specifies what \c satisfying_iterator yields
+ */
+enum class satisfy_mode
+{
+    /**
+     *  \brief Full variable assignments
+     */
+    Assignments,
+
+    /**
+     *  \brief Cubes where skipped variables have value \c DontCare
+     */
+    Cubes
+};
+
+/**
+ *  \brief Lazily enumerates variable assignments for which a function
+ *  evaluates to a given value
+ *
+ *  Uses explicit stack instead of recursion so that the enumeration can
+ *  be stopped and resumed at any point. The constructor numbers the nodes
+ *  in one traversal and keeps their sons and levels in dense arrays,
+ *  together with a flag telling whether the value is reachable from
+ *  a node. Subdiagrams that cannot reach the value are never entered,
+ *  so the time between two assignments is bounded by the number of
+ *  levels. Other traversals can run while the iterator is in use but
+ *  the manager must not reorder variables.
+ */
+template<class Data, class Degree, class Domain>
+class satisfying_iterator
+{
+public:
+    using node_manager_t    = node_manager<Data, Degree, Domain>;
+    using node_t            = typename node_manager_t::node_t;
+    using difference_type   = std::ptrdiff_t;
+    using value_type        = std::vector<int32>;
+    using reference         = value_type const&;
+    using pointer           = value_type const*;
+    using iterator_category = std::input_iterator_tag;
+
+public:
+    /**
+     *  \brief Initializes iterator that is equal to the end sentinel
+     */
+    satisfying_iterator();
+
+    /**
+     *  \brief Initializes iterator pointing to the first assignment
+     *  \param nodes Node manager that owns the diagram
+     *  \param root Root of the diagram
+     *  \param value Value of the function
+     *  \param mode Specifies whether to yield assignments or cubes
+     */
+    satisfying_iterator(
+        node_manager_t const* nodes,
+        node_t* root,
+        int32 value,
+        satisfy_mode mode
+    );
+
+    auto operator* () const -> reference;
+    auto operator->() const -> pointer;
+    auto operator++ () -> satisfying_iterator&;
+    auto operator++ (int) -> void;
+    auto operator== (std::default_sentinel_t) const -> bool;
+
+private:
+    struct frame
+    {
+        int32 node_;
+        int32 level_;
+        int32 nextValue_;
+    };
+
+private:
+    /**
+     *  \brief Moves to the next assignment
+     *  \return false if there are no more assignments
+     */
+    auto find_next () -> bool;
+
+    /**
+     *  \brief Numbers nodes of the diagram and fills the arrays
+     *  of sons, levels, and reachability flags
+     *  \return Id of \p root
+     */
+    auto number_nodes (node_t* root) -> int32;
+
+    /**
+     *  \brief Skips levels above node with id \p node
+     *  in the \c Cubes mode
+     *  \return Level where the enumeration continues
+     */
+    auto skip_levels (int32 node, int32 level) -> int32;
+
+private:
+    node_manager_t const* nodes_;
+    // Indexed by node ids, sons of i-th node start at firstSon_[i].
+    std::vector<int64> firstSon_;
+    std::vector<int32> sons_;
+    std::vector<int32> levels_;
+    std::vector<bool> reaches_;
+    std::vector<frame> stack_;
+    std::vector<int32> vars_;
+    int32 value_;
+    satisfy_mode mode_;
+    bool isEnd_;
+};
+
+/**
+ *  \brief Range of assignments produced by \c satisfying_iterator
+ */
+template<class Data, class Degree, class Domain>
+class satisfying_range
+{
+public:
+    using iterator = satisfying_iterator<Data, Degree, Domain>;
+
+public:
+    satisfying_range(
+        typename iterator::node_manager_t const* nodes,
+        typename iterator::node_t* root,
+        int32 value,
+        satisfy_mode mode
+    );
+
+    [[nodiscard]] auto begin () const -> iterator;
+    [[nodiscard]] auto end () const -> std::default_sentinel_t;
+
+private:
+    typename iterator::node_manager_t const* nodes_;
+    typename iterator::node_t* root_;
+    int32 value_;
+    satisfy_mode mode_;
+};
+
+template<class Data, class Degree, class Domain>
+satisfying_iterator<Data, Degree, Domain>::satisfying_iterator() :
+    nodes_(nullptr),
+    firstSon_(),
+    sons_(),
+    levels_(),
+    reaches_(),
+    stack_(),
+    vars_(),
+    value_(0),
+    mode_(satisfy_mode::Assignments),
+    isEnd_(true)
+{
+}
+
+template<class Data, class Degree, class Domain>
+satisfying_iterator<Data, Degree, Domain>::satisfying_iterator(
+    node_manager_t const* const nodes,
+    node_t* const root,
+    int32 const value,
+    satisfy_mode const mode
+) :
+    nodes_(nodes),
+    firstSon_(),
+    sons_(),
+    levels_(),
+    reaches_(),
+    stack_(),
+    vars_(as_usize(nodes->get_var_count()), 0),
+    value_(value),
+    mode_(mode),
+    isEnd_(false)
+{
+    if (root->is_terminal() && root->get_value() != value)
+    {
+        isEnd_ = true;
+        return;
+    }
+
+    // Terminal root with the value gets id 0 and is always reachable.
+    int32 const rootId = this->number_nodes(root);
+    if (not reaches_[as_uindex(rootId)])
+    {
+        isEnd_ = true;
+        return;
+    }
+
+    int32 const level = this->skip_levels(rootId, 0);
+    if (level == nodes_->get_leaf_level())
+    {
+        // Constant function or function of no variables.
+        return;
+    }
+
+    stack_.push_back(frame {rootId, level, 0});
+    isEnd_ = not this->find_next();
+}
+
+template<class Data, class Degree, class Domain>
+auto satisfying_iterator<Data, Degree, Domain>::operator* () const
+    -> reference
+{
+    return vars_;
+}
+
+template<class Data, class Degree, class Domain>
+auto satisfying_iterator<Data, Degree, Domain>::operator->() const -> pointer
+{
+    return &vars_;
+}
+
+template<class Data, class Degree, class Domain>
+auto satisfying_iterator<Data, Degree, Domain>::operator++ ()
+    -> satisfying_iterator&
+{
+    isEnd_ = not this->find_next();
+    return *this;
+}
+
+template<class Data, class Degree, class Domain>
+auto satisfying_iterator<Data, Degree, Domain>::operator++ (int) -> void
+{
+    ++(*this);
+}
+
+template<class Data, class Degree, class Domain>
+auto satisfying_iterator<Data, Degree, Domain>::operator== (
+    std::default_sentinel_t
+) const -> bool
+{
+    return isEnd_;
+}
+
+template<class Data, class Degree, class Domain>
+auto satisfying_iterator<Data, Degree, Domain>::find_next() -> bool
+{
+    int32 const leafLevel = nodes_->get_leaf_level();
+    while (not stack_.empty())
+    {
+        frame& top         = stack_.back();
+        int32 const index  = nodes_->get_index(top.level_);
+        int32 const domain = nodes_->get_domain(index);
+        if (top.nextValue_ == domain)
+        {
+            stack_.pop_back();
+            continue;
+        }
+
+        // Node is below the current level if the level was skipped.
+        int32 const varValue = top.nextValue_++;
+        bool const isSkipped = levels_[as_uindex(top.node_)] > top.level_;
+        int64 const sonPos   = firstSon_[as_uindex(top.node_)] + varValue;
+        int32 const next     = isSkipped ? top.node_
+                                         : sons_[as_uindex(sonPos)];
+        vars_[as_uindex(index)] = varValue;
+        if (not reaches_[as_uindex(next)])
+        {
+            continue;
+        }
+
+        int32 const nextLevel = this->skip_levels(next, top.level_ + 1);
+        if (nextLevel == leafLevel)
+        {
+            return true;
+        }
+
+        stack_.push_back(frame {next, nextLevel, 0});
+    }
+    return false;
+}
+
+template<class Data, class Degree, class Domain>
+auto satisfying_iterator<Data, Degree, Domain>::number_nodes(
+    node_t* const root
+) -> int32
+{
+    int32 const value = value_;
+    int64 const count = nodes_->traverse_post_numbered(
+        root,
+        [this, value] (node_t* const node)
+        {
+            levels_.push_back(nodes_->get_level(node));
+            firstSon_.push_back(ssize(sons_));
+            if (node->is_terminal())
+            {
+                reaches_.push_back(node->get_value() == value);
+                return;
+            }
+
+            // Sons are numbered before their parent.
+            bool reaches       = false;
+            int32 const domain = nodes_->get_domain(node);
+            for (int32 k = 0; k < domain; ++k)
+            {
+                int32 const sonId = node->get_son(k)->get_scratch();
+                sons_.push_back(sonId);
+                reaches = reaches || reaches_[as_uindex(sonId)];
+            }
+            reaches_.push_back(reaches);
+        }
+    );
+    return static_cast<int32>(count - 1);
+}
+
+template<class Data, class Degree, class Domain>
+auto satisfying_iterator<Data, Degree, Domain>::skip_levels(
+    int32 const node,
+    int32 const level
+) -> int32
+{
+    if (mode_ == satisfy_mode::Assignments)
+    {
+        return level;
+    }
+
+    int32 const nodeLevel = levels_[as_uindex(node)];
+    for (int32 skipped = level; skipped < nodeLevel; ++skipped)
+    {
+        vars_[as_uindex(nodes_->get_index(skipped))] = DontCare;
+    }
+    return nodeLevel;
+}
+
+template<class Data, class Degree, class Domain>
+satisfying_range<Data, Degree, Domain>::satisfying_range(
+    typename iterator::node_manager_t const* const nodes,
+    typename iterator::node_t* const root,
+    int32 const value,
+    satisfy_mode const mode
+) :
+    nodes_(nodes),
+    root_(root),
+    value_(value),
+    mode_(mode)
+{
+}
+
+template<class Data, class Degree, class Domain>
+auto satisfying_range<Data, Degree, Domain>::begin() const -> iterator
+{
+    return iterator(nodes_, root_, value_, mode_);
+}
+
+template<class Data, class Degree, class Domain>
+auto satisfying_range<Data, Degree, Domain>::end() const
+    -> std::default_sentinel_t
+{
+    return std::default_sentinel;
+}
+} // namespace teddy
+
+#endif
@@ -32,6 +32,8 @@ struct teddy_stats
     query_frequency applyCacheQueries_;
     operation_duration collectGarbage_;
     operation_duration makeNode_;
+    operation_duration plaParse_;
+    operation_duration plaBuild_;
 };
 
 inline auto get_stats () -> teddy_stats&
@@ -74,7 +76,13 @@ inline auto dump_stats () -> void
               << "  total = " << stats.makeNode_.total_.count() << "ns\n"
               << "Apply step"
               << "\n"
-              << "  calls = " << stats.applyStepCalls_ << "\n";
+              << "  calls = " << stats.applyStepCalls_ << "\n"
+              << "PLA parse"
+              << "\n"
+              << "  total = " << stats.plaParse_.total_.count() << "ns\n"
+              << "PLA build"
+              << "\n"
+              << "  total = " << stats.plaBuild_.total_.count() << "ns\n";
 }
 } // namespace teddy
 
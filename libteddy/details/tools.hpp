@@ -221,6 +221,17 @@ constexpr auto swap (T& first, T& second) noexcept -> void
     second   = tmp;
 }
 
+/**
+ *  \brief Hints the processor to load \p address into the cache
+ *  Does nothing on compilers that do not support the hint
+ */
+inline auto prefetch ([[maybe_unused]] void const* const address) -> void
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address);
+#endif
+}
+
 /**
  *  \brief Simple heapsort for vectors
  */
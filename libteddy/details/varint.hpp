@@ -0,0 +1,54 @@
+#ifndef LIBTEDDY_DETAILS_VARINT_HPP
+#define LIBTEDDY_DETAILS_VARINT_HPP
+
+#include <libteddy/details/types.hpp>
+
+#include <istream>
+#include <optional>
+#include <ostream>
+
+namespace teddy::utils
+{
+/**
+ *  \brief Writes \p value using 7 bits per byte, least significant first
+ *
+ *  The highest bit of each byte is set if more bytes follow so that
+ *  small values take a single byte.
+ */
+inline auto write_varint (std::ostream& out, uint64 value) -> void
+{
+    while (value >= 0x80)
+    {
+        out.put(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.put(static_cast<char>(value));
+}
+
+/**
+ *  \brief Reads value written by \c write_varint
+ *  \return Optional holding the value or \c std::nullopt if the stream
+ *  ended or the value does not fit into 64 bits
+ */
+inline auto read_varint (std::istream& in) -> std::optional<uint64>
+{
+    uint64 value = 0;
+    for (int32 shift = 0; shift < 64; shift += 7)
+    {
+        int const byte = in.get();
+        if (byte == std::istream::traits_type::eof())
+        {
+            return std::nullopt;
+        }
+
+        value |= static_cast<uint64>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return value;
+        }
+    }
+    return std::nullopt;
+}
+} // namespace teddy::utils
+
+#endif
@@ -0,0 +1,968 @@
+#ifndef LIBTEDDY_DETAILS_ZDD_MANAGER_HPP
+#define LIBTEDDY_DETAILS_ZDD_MANAGER_HPP
+
+#include <libteddy/details/diagram.hpp>
+#include <libteddy/details/diagram_manager.hpp>
+#include <libteddy/details/node_manager.hpp>
+#include <libteddy/details/operators.hpp>
+#include <libteddy/details/tools.hpp>
+#include <libteddy/details/types.hpp>
+
+#include <cassert>
+#include <iterator>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+namespace teddy
+{
+namespace details
+{
+/**
+ *  \brief Cache tag for the minimal elements of a family
+ */
+struct zdd_minimal : operation_info<20, false>
+{
+};
+
+/**
+ *  \brief Cache tag for the non-superset operation on families
+ */
+struct zdd_nonsup : operation_info<21, false>
+{
+};
+} // namespace details
+
+/**
+ *  \class zdd_manager
+ *  \brief Base class for managers of Zero-suppressed Decision Diagrams
+ *
+ *  Diagram represents a family of vectors of variable values. Node is
+ *  removed if all of its sons except the 0-son point to the terminal 0.
+ *  Therefore, variables that are skipped on a path have value 0.
+ *  Terminal 0 represents the empty family, terminal 1 represents
+ *  the family containing only the vector of zeros. Sparse families such
+ *  as families of cut sets or cut vectors are represented compactly
+ *  and can be counted without enumeration.
+ *
+ *  Order of variables is fixed, reordering is not supported.
+ *
+ *  \tparam Degree Node degree
+ *  \tparam Domain Variable domains
+ */
+template<class Degree, class Domain>
+class zdd_manager
+{
+public:
+    /**
+     *  \brief Alias for the diagram type used in the
+     *  functions of this manager.
+     */
+    using diagram_t = diagram<void, Degree>;
+
+public:
+    /**
+     *  \brief Creates diagram representing the empty family
+     *  \return Diagram representing the empty family
+     */
+    auto empty () -> diagram_t;
+
+    /**
+     *  \brief Creates diagram representing family that contains
+     *  only the vector of zeros
+     *  \return Diagram representing the unit family
+     */
+    auto base () -> diagram_t;
+
+    /**
+     *  \brief Creates diagram representing family that contains
+     *  single vector with exactly one non-zero element
+     *  \param index Index of the variable
+     *  \param value Value of the variable
+     *  \return Diagram representing the family
+     */
+    auto singleton (int32 index, int32 value) -> diagram_t;
+
+    /**
+     *  \brief Converts decision diagram to the family of vectors
+     *  for which it evaluates to \p value
+     *
+     *  Manager of the diagram must have the same number of variables,
+     *  the same domains and the same order of variables.
+     *
+     *  \param manager Manager of the \p diagram
+     *  \param diagram Decision diagram
+     *  \param value Value of the function
+     *  \return Diagram representing family of vectors
+     */
+    template<class Data, class D, class Dm>
+    auto from_diagram (
+        diagram_manager<Data, D, Dm> const& manager,
+        diagram<Data, D> const& diagram,
+        int32 value = 1
+    ) -> diagram_t;
+
+    /**
+     *  \brief Calculates union of two families
+     *  \param lhs First family
+     *  \param rhs Second family
+     *  \return Diagram representing union of \p lhs and \p rhs
+     */
+    auto family_union (diagram_t const& lhs, diagram_t const& rhs)
+        -> diagram_t;
+
+    /**
+     *  \brief Calculates intersection of two families
+     *  \param lhs First family
+     *  \param rhs Second family
+     *  \return Diagram representing intersection of \p lhs and \p rhs
+     */
+    auto family_intersection (diagram_t const& lhs, diagram_t const& rhs)
+        -> diagram_t;
+
+    /**
+     *  \brief Calculates difference of two families
+     *  \param lhs First family
+     *  \param rhs Second family
+     *  \return Diagram representing vectors of \p lhs not in \p rhs
+     */
+    auto family_difference (diagram_t const& lhs, diagram_t const& rhs)
+        -> diagram_t;
+
+    /**
+     *  \brief Calculates minimal vectors of the family
+     *
+     *  Vectors are compared element-wise. Vector is minimal if there
+     *  is no other vector in the family that is less or equal in
+     *  all elements. Minimal cut vectors of a coherent system are
+     *  the minimal elements of the family of its cut vectors.
+     *
+     *  \param family Family of vectors
+     *  \return Diagram representing minimal vectors of \p family
+     */
+    auto minimal (diagram_t const& family) -> diagram_t;
+
+    /**
+     *  \brief Calculates number of vectors in the family
+     *
+     *  Complexity is \c O(|d|) where \c |d| is the number of nodes.
+     *
+     *  \param family Family of vectors
+     *  \return Number of vectors in \p family
+     */
+    auto count (diagram_t const& family) const -> int64;
+
+    /**
+     *  \brief Checks whether the family contains given vector
+     *
+     *  Complexity is \c O(n) where \c n is the number of variables.
+     *
+     *  \tparam Vars Container type that defines operator[] and returns
+     *  value convertible to int
+     *  \param family Family of vectors
+     *  \param values Vector of variable values
+     *  \return True if \p family contains \p values, false otherwise
+     */
+    template<in_var_values Vars>
+    auto contains (diagram_t const& family, Vars const& values) const -> bool;
+
+    /**
+     *  \brief Enumerates all vectors of the family
+     *  \tparam Vars Container type that defines operator[] and allows
+     *  assigning integers e.g. std::vector<int32>
+     *  \param family Family of vectors
+     *  \return Vector of \p Vars
+     */
+    template<out_var_values Vars>
+    auto enumerate (diagram_t const& family) const -> std::vector<Vars>;
+
+    /**
+     *  \brief Enumerates all vectors of the family
+     *
+     *  Outputs the vectors using the output iterator \p out .
+     *
+     *  \tparam Vars Container type that defines operator[] and allows
+     *  assigning integers e.g. std::vector<int32>
+     *  \tparam OutputIt Output iterator type
+     *  \param family Family of vectors
+     *  \param out Output iterator
+     */
+    template<out_var_values Vars, std::output_iterator<Vars> OutputIt>
+    auto enumerate_g (diagram_t const& family, OutputIt out) const -> void;
+
+    /**
+     *  \brief Returns number of nodes that are currently
+     *  used by the manager.
+     *  \return Number of nodes
+     */
+    [[nodiscard]] auto get_node_count () const -> int64;
+
+    /**
+     *  \brief Returns number of nodes in the diagram including
+     *  terminal nodes
+     *  \param diagram Diagram
+     *  \return Number of node
+     */
+    auto get_node_count (diagram_t const& diagram) const -> int64;
+
+    /**
+     *  \brief Prints dot representation of the graph
+     *  \param out Output stream (e.g. \c std::cout or \c std::ofstream )
+     */
+    auto to_dot_graph (std::ostream& out) const -> void;
+
+    /**
+     *  \brief Prints dot representation of the diagram
+     *  \param out Output stream (e.g. \c std::cout or \c std::ofstream )
+     *  \param diagram Diagram
+     */
+    auto to_dot_graph (std::ostream& out, diagram_t const& diagram) const
+        -> void;
+
+    /**
+     *  \brief Runs garbage collection.
+     */
+    auto force_gc () -> void;
+
+    /**
+     *  \brief Clears apply cache.
+     */
+    auto clear_cache () -> void;
+
+    /**
+     *  \brief Returns number of variables for this manager
+     *  set in the constructor.
+     *  \return Number of variables.
+     */
+    [[nodiscard]] auto get_var_count () const -> int32;
+
+    /**
+     *  \brief Returns order of variables.
+     *  \return Vector of indices. Index at l-th position is the
+     *  index of variable at l-th level of the diagram.
+     */
+    [[nodiscard]] auto get_order () const -> std::vector<int32> const&;
+
+    /**
+     *  \brief Returns domains of variables.
+     *  \return Vector of domains.
+     */
+    [[nodiscard]] auto get_domains () const -> std::vector<int32>;
+
+    /**
+     *  \brief Sets the relative cache size w.r.t the number of nodes
+     *  \param ratio Number from the interval (0,oo)
+     */
+    auto set_cache_ratio (double ratio) -> void;
+
+    /**
+     *  \brief Sets ratio used to determine new node pool allocation
+     *  \param ratio Number from the interval [0,1]
+     */
+    auto set_gc_ratio (double ratio) -> void;
+
+protected:
+    /**
+     *  \brief Initializes ZDD manager.
+     *
+     *  This overload is for managers that have fixed domains.
+     *
+     *  \param varCount Number of variables.
+     *  \param nodePoolSize Size of the main node pool.
+     *  \param extraNodePoolSize Size of the additional node pools.
+     *  \param order Order of variables.
+     */
+    zdd_manager(
+        int32 varCount,
+        int64 nodePoolSize,
+        int64 extraNodePoolSize,
+        std::vector<int32> order
+    )
+    requires(domains::is_fixed<Domain>::value);
+
+    /**
+     *  \brief Initializes ZDD manager.
+     *
+     *  This overload is for managers that have mixed domains.
+     *
+     *  \param varCount Number of variables.
+     *  \param nodePoolSize Size of the main node pool.
+     *  \param extraNodePoolSize Size of the additional node pools.
+     *  \param domain Domains of variables.
+     *  \param order Order of variables.
+     */
+    zdd_manager(
+        int32 varCount,
+        int64 nodePoolSize,
+        int64 extraNodePoolSize,
+        domains::mixed domain,
+        std::vector<int32> order
+    )
+    requires(domains::is_mixed<Domain>::value);
+
+public:
+    zdd_manager(zdd_manager&&) noexcept                     = default;
+    ~zdd_manager()                                          = default;
+    auto operator= (zdd_manager&&) noexcept -> zdd_manager& = default;
+    zdd_manager(zdd_manager const&)                         = delete;
+    auto operator= (zdd_manager const&) -> zdd_manager&     = delete;
+
+private:
+    using node_t        = typename diagram_t::node_t;
+    using son_container = typename node_t::son_container;
+
+private:
+    [[nodiscard]] auto make_zero () -> node_t*;
+    [[nodiscard]] static auto is_zero (node_t* node) -> bool;
+
+    template<class SourceNode>
+    auto from_diagram_impl (
+        std::vector<std::unordered_map<SourceNode*, node_t*>>& memo,
+        SourceNode* node,
+        int32 level,
+        int32 value
+    ) -> node_t*;
+
+    template<teddy_bin_op Op>
+    auto apply_impl (node_t* lhs, node_t* rhs) -> node_t*;
+
+    auto minimal_impl (node_t* node) -> node_t*;
+
+    auto nonsup_impl (node_t* lhs, node_t* rhs) -> node_t*;
+
+    [[nodiscard]] static auto contains_zero (node_t* node) -> bool;
+
+    static auto release (node_t* node) -> void;
+
+    static auto disown_sons (son_container const& sons, int32 domain) -> void;
+
+    auto make_result (node_t* root) -> diagram_t;
+
+    template<class Vars, class OutputIt>
+    auto enumerate_impl (Vars& vars, OutputIt& out, node_t* node) const
+        -> void;
+
+private:
+    node_manager<void, Degree, Domain> nodes_;
+};
+
+template<class Degree, class Domain>
+auto zdd_manager<Degree, Domain>::empty() -> diagram_t
+{
+    return diagram_t(this->make_zero());
+}
+
+template<class Degree, class Domain>
+auto zdd_manager<Degree, Domain>::base() -> diagram_t
+{
+    return diagram_t(nodes_.make_terminal_node(1));
+}
+
+template<class Degree, class Domain>
+auto zdd_manager<Degree, Domain>::singleton(
+    int32 const index,
+    int32 const value
+) -> diagram_t
+{
+    assert(nodes_.is_valid_var_value(index, value));
+    int32 const domain = nodes_.get_domain(index);
+    son_container sons = nodes_.make_son_container(domain);
+    for (int32 k = 0; k < domain; ++k)
+    {
+        sons[k] = k == value ? nodes_.make_terminal_node(1)
+                             : this->make_zero();
+    }
+    return this->make_result(nodes_.make_zero_suppressed_node(index, sons));
+}
+
+template<class Degree, class Domain>
+template<class Data, class D, class Dm>
+auto zdd_manager<Degree, Domain>::from_diagram(
+    [[maybe_unused]] diagram_manager<Data, D, Dm> const& manager,
+    diagram<Data, D> const& diagram,
+    int32 const value
+) -> diagram_t
+{
+    assert(manager.get_var_count() == this->get_var_count());
+    assert(manager.get_order() == this->get_order());
+    assert(manager.get_domains() == this->get_domains());
+
+    std::vector<std::unordered_map<node<Data, D>*, node_t*>> memo(
+        as_usize(this->get_var_count())
+    );
+    node_t* const root = this->from_diagram_impl(
+        memo,
+        diagram.unsafe_get_root(),
+        0,
+        value
+    );
+    return this->make_result(root);
+}
+
+template<class Degree, class Domain>
+auto zdd_manager<Degree, Domain>::family_union(
+    diagram_t const& lhs,
+    diagram_t const& rhs
+) -> diagram_t
+{
+    return this->make_result(this->apply_impl<ops::OR>(
+        lhs.unsafe_get_root(),
+        rhs.unsafe_get_root()
+    ));
+}
+
+template<class Degree, class Domain>
+auto zdd_manager<Degree, Domain>::family_intersection(
+    diagram_t const& lhs,
+    diagram_t const& rhs
+) -> diagram_t
+{
+    return this->make_result(this->apply_impl<ops::AND>(
+        lhs.unsafe_get_root(),
+        rhs.unsafe_get_root()
+    ));
+}
+
+template<class Degree, class Domain>
+auto zdd_manager<Degree, Domain>::family_difference(
+    diagram_t const& lhs,
+    diagram_t const& rhs
+) -> diagram_t
+{
+    return this->make_result(this->apply_impl<ops::GREATER>(
+        lhs.unsafe_get_root(),
+        rhs.unsafe_get_root()
+    ));
+}
+
+template<class Degree, class Domain>
+auto zdd_manager<Degree, Domain>::minimal(diagram_t const& family)
+    -> diagram_t
+{
+    return this->make_result(this->minimal_impl(family.unsafe_get_root()));
+}
+
+template<class Degree, class Domain>
+auto zdd_manager<Degree, Domain>::count(diagram_t const& family) const
+    -> int64
+{
+    std::vector<int64>& counts = nodes_.get_scratch_buffer();
+    nodes_.traverse_post_numbered(
+        family.unsafe_get_root(),
+        [this, &counts] (node_t* const node)
+        {
+            if (node->is_terminal())
+            {
+                counts.push_back(node->get_value());
+            }
+            else
+            {
+                int64 count = 0;
+                nodes_.for_each_son(
+                    node,
+                    [&counts, &count] (node_t* const son)
+                    { count += counts[as_uindex(son->get_scratch())]; }
+                );
+                counts.push_back(count);
+            }
+        }
+    );
+    return counts.back();
+}
+
+template<class Degree, class Domain>
+template<in_var_values Vars>
+auto zdd_manager<Degree, Domain>::contains(
+    diagram_t const& family,
+    Vars const& values
+) const -> bool
+{
+    node_t* node          = family.unsafe_get_root();
+    int32 const leafLevel = nodes_.get_leaf_level();
+    for (int32 level = 0; level < leafLevel; ++level)
+    {
+        int32 const index = nodes_.get_index(level);
+        int32 const value = values[as_uindex(index)];
+        assert(nodes_.is_valid_var_value(index, value));
+        if (nodes_.get_level(node) == level)
+        {
+            node = node->get_son(value);
+        }
+        else if (value != 0)
+        {
+            // Skipped variables have value 0.
+            return false;
+        }
+    }
+    return node->get_value() == 1;
+}
+
+template<class Degree, class Domain>
+template<out_var_values Vars>
+auto zdd_manager<Degree, Domain>::enumerate(diagram_t const& family) const
+    -> std::vector<Vars>
+{
+    std::vector<Vars> result;
+    this->enumerate_g<Vars>(family, std::back_inserter(result));
+    return result;
+}
+
+template<class Degree, class Domain>
+template<out_var_values Vars, std::output_iterator<Vars> OutputIt>
+auto zdd_manager<Degree, Domain>::enumerate_g(
+    diagram_t const& family,
+    OutputIt out
+) const -> void
+{
+    Vars vars;
+    if constexpr (utils::is_std_vector<Vars>)
+    {
+        vars.resize(as_usize(this->get_var_count()));
+    }
+    for (int32 index = 0; index < this->get_var_count(); ++index)
+    {
+        vars[as_uindex(index)] = 0;
+    }
+    this->enumerate_impl(vars, out, family.unsafe_get_root());
+}
+
+template<class Degree, class Domain>
+auto zdd_manager<Degree, Domain>::get_node_count() const -> int64
+{
+    return nodes_.get_node_count();
+}
+
+template<class Degree, class Domain>
+auto zdd_manager<Degree, Domain>::get_node_count(diagram_t const& diagram
+) const -> int64
+{
+    return nodes_.get_node_count(diagram.unsafe_get_root());
+}
+
+template<class Degree, class Domain>
+auto zdd_manager<Degree, Domain>::to_dot_graph(std::ostream& out) const
+    -> void
+{
+    nodes_.to_dot_graph(out);
+}
+
+template<class Degree, class Domain>
+auto zdd_manager<Degree, Domain>::to_dot_graph(
+    std::ostream& out,
+    diagram_t const& diagram
+) const -> void
+{
+    nodes_.to_dot_graph(out, diagram.unsafe_get_root());
+}
+
+template<class Degree, class Domain>
+auto zdd_manager<Degree, Domain>::force_gc() -> void
+{
+    nodes_.force_gc();
+}
+
+template<class Degree, class Domain>
+auto zdd_manager<Degree, Domain>::clear_cache() -> void
+{
+    nodes_.cache_clear();
+}
+
+template<class Degree, class Domain>
+auto zdd_manager<Degree, Domain>::get_var_count() const -> int32
+{
+    return nodes_.get_var_count();
+}
+
+template<class Degree, class Domain>
+auto zdd_manager<Degree, Domain>::get_order() const
+    -> std::vector<int32> const&
+{
+    return nodes_.get_order();
+}
+
+template<class Degree, class Domain>
+auto zdd_manager<Degree, Domain>::get_domains() const -> std::vector<int32>
+{
+    return nodes_.get_domains();
+}
+
+template<class Degree, class Domain>
+auto zdd_manager<Degree, Domain>::set_cache_ratio(double const ratio) -> void
+{
+    nodes_.set_cache_ratio(ratio);
+}
+
+template<class Degree, class Domain>
+auto zdd_manager<Degree, Domain>::set_gc_ratio(double const ratio) -> void
+{
+    nodes_.set_gc_ratio(ratio);
+}
+
+template<class Degree, class Domain>
+zdd_manager<Degree, Domain>::zdd_manager(
+    int32 const varCount,
+    int64 const nodePoolSize,
+    int64 const extraNodePoolSize,
+    std::vector<int32> order
+)
+requires(domains::is_fixed<Domain>::value)
+    :
+    nodes_(
+        varCount,
+        nodePoolSize,
+        extraNodePoolSize,
+        detail::default_or_fwd(varCount, order)
+    )
+{
+}
+
+template<class Degree, class Domain>
+zdd_manager<Degree, Domain>::zdd_manager(
+    int32 const varCount,
+    int64 const nodePoolSize,
+    int64 const extraNodePoolSize,
+    domains::mixed domain,
+    std::vector<int32> order
+)
+requires(domains::is_mixed<Domain>::value)
+    :
+    nodes_(
+        varCount,
+        nodePoolSize,
+        extraNodePoolSize,
+        detail::default_or_fwd(varCount, order),
+        static_cast<domains::mixed&&>(domain)
+    )
+{
+}
+
+template<class Degree, class Domain>
+auto zdd_manager<Degree, Domain>::make_zero() -> node_t*
+{
+    return nodes_.make_terminal_node(0);
+}
+
+template<class Degree, class Domain>
+auto zdd_manager<Degree, Domain>::is_zero(node_t* const node) -> bool
+{
+    return node->is_terminal() && node->get_value() == 0;
+}
+
+template<class Degree, class Domain>
+template<class SourceNode>
+auto zdd_manager<Degree, Domain>::from_diagram_impl(
+    std::vector<std::unordered_map<SourceNode*, node_t*>>& memo,
+    SourceNode* const node,
+    int32 const level,
+    int32 const value
+) -> node_t*
+{
+    if (node->is_terminal() && node->get_value() != value)
+    {
+        return this->make_zero();
+    }
+
+    if (level == nodes_.get_leaf_level())
+    {
+        return nodes_.make_terminal_node(1);
+    }
+
+    auto& levelMemo = memo[as_uindex(level)];
+    auto const it   = levelMemo.find(node);
+    if (it != levelMemo.end())
+    {
+        return it->second;
+    }
+
+    // Variable that is skipped in the source diagram can have
+    // any value, i.e., all sons of the new node are the same.
+    int32 const index    = nodes_.get_index(level);
+    int32 const domain   = nodes_.get_domain(index);
+    bool const isSkipped = node->is_terminal() || node->get_index() != index;
+    son_container sons   = nodes_.make_son_container(domain);
+    for (int32 k = 0; k < domain; ++k)
+    {
+        SourceNode* const son = isSkipped ? node : node->get_son(k);
+        sons[k] = this->from_diagram_impl(memo, son, level + 1, value);
+    }
+
+    node_t* const result = nodes_.make_zero_suppressed_node(index, sons);
+    levelMemo.emplace(node, result);
+    return result;
+}
+
+template<class Degree, class Domain>
+template<teddy_bin_op Op>
+auto zdd_manager<Degree, Domain>::apply_impl(
+    node_t* const lhs,
+    node_t* const rhs
+) -> node_t*
+{
+    if constexpr (utils::is_same<Op, ops::OR>::value)
+    {
+        if (lhs == rhs || is_zero(rhs))
+        {
+            return lhs;
+        }
+        if (is_zero(lhs))
+        {
+            return rhs;
+        }
+    }
+    else if constexpr (utils::is_same<Op, ops::AND>::value)
+    {
+        if (lhs == rhs)
+        {
+            return lhs;
+        }
+        if (is_zero(lhs) || is_zero(rhs))
+        {
+            return this->make_zero();
+        }
+    }
+    else if constexpr (utils::is_same<Op, ops::GREATER>::value)
+    {
+        if (lhs == rhs || is_zero(lhs))
+        {
+            return this->make_zero();
+        }
+        if (is_zero(rhs))
+        {
+            return lhs;
+        }
+    }
+
+    if (lhs->is_terminal() && rhs->is_terminal())
+    {
+        return nodes_.make_terminal_node(
+            Op()(lhs->get_value(), rhs->get_value())
+        );
+    }
+
+    node_t* const cached = nodes_.template cache_find<Op>(lhs, rhs);
+    if (cached)
+    {
+        return cached;
+    }
+
+    // Vectors from the family without the top variable
+    // have 0 at its position.
+    int32 const lhsLevel = nodes_.get_level(lhs);
+    int32 const rhsLevel = nodes_.get_level(rhs);
+    int32 const topLevel = utils::min(lhsLevel, rhsLevel);
+    int32 const topIndex = nodes_.get_index(topLevel);
+    int32 const domain   = nodes_.get_domain(topIndex);
+    son_container sons   = nodes_.make_son_container(domain);
+    for (int32 k = 0; k < domain; ++k)
+    {
+        node_t* const fst = lhsLevel == topLevel ? lhs->get_son(k)
+                          : k == 0               ? lhs
+                                                 : this->make_zero();
+        node_t* const snd = rhsLevel == topLevel ? rhs->get_son(k)
+                          : k == 0               ? rhs
+                                                 : this->make_zero();
+        sons[k] = this->apply_impl<Op>(fst, snd);
+    }
+
+    node_t* const result = nodes_.make_zero_suppressed_node(topIndex, sons);
+    nodes_.template cache_put<Op>(result, lhs, rhs);
+    return result;
+}
+
+template<class Degree, class Domain>
+auto zdd_manager<Degree, Domain>::minimal_impl(node_t* const node) -> node_t*
+{
+    if (node->is_terminal())
+    {
+        return node;
+    }
+
+    node_t* const cached
+        = nodes_.template cache_find<details::zdd_minimal>(node, node);
+    if (cached)
+    {
+        return cached;
+    }
+
+    // Vector with value k of the top variable is minimal if it is
+    // minimal in the k-th subfamily and it does not dominate any
+    // vector from the subfamilies with lower values.
+    int32 const index  = node->get_index();
+    int32 const domain = nodes_.get_domain(index);
+    son_container sons = nodes_.make_son_container(domain);
+    for (int32 k = 0; k < domain; ++k)
+    {
+        node_t* son = id_inc_ref_count(this->minimal_impl(node->get_son(k)));
+        for (int32 j = 0; j < k; ++j)
+        {
+            node_t* const next
+                = id_inc_ref_count(this->nonsup_impl(son, node->get_son(j)));
+            release(son);
+            son = next;
+        }
+        sons[k] = son;
+    }
+    disown_sons(sons, domain);
+
+    node_t* const result = nodes_.make_zero_suppressed_node(index, sons);
+    nodes_.template cache_put<details::zdd_minimal>(result, node, node);
+    return result;
+}
+
+template<class Degree, class Domain>
+auto zdd_manager<Degree, Domain>::nonsup_impl(
+    node_t* const lhs,
+    node_t* const rhs
+) -> node_t*
+{
+    // Removes vectors from lhs that are greater or equal
+    // in all elements to some vector from rhs.
+
+    if (is_zero(lhs) || lhs == rhs)
+    {
+        return this->make_zero();
+    }
+
+    if (is_zero(rhs))
+    {
+        return lhs;
+    }
+
+    if (rhs->is_terminal())
+    {
+        // Every vector dominates the vector of zeros.
+        return this->make_zero();
+    }
+
+    if (lhs->is_terminal())
+    {
+        // Vector of zeros dominates only itself.
+        return contains_zero(rhs) ? this->make_zero() : lhs;
+    }
+
+    node_t* const cached
+        = nodes_.template cache_find<details::zdd_nonsup>(lhs, rhs);
+    if (cached)
+    {
+        return cached;
+    }
+
+    int32 const lhsLevel = nodes_.get_level(lhs);
+    int32 const rhsLevel = nodes_.get_level(rhs);
+    node_t* result       = nullptr;
+    if (rhsLevel < lhsLevel)
+    {
+        // Vectors from lhs have 0 at the position of the top variable,
+        // they can only dominate vectors from the 0-subfamily of rhs.
+        result = this->nonsup_impl(lhs, rhs->get_son(0));
+    }
+    else
+    {
+        int32 const index  = lhs->get_index();
+        int32 const domain = nodes_.get_domain(index);
+        son_container sons = nodes_.make_son_container(domain);
+        for (int32 k = 0; k < domain; ++k)
+        {
+            node_t* son = id_inc_ref_count(lhs->get_son(k));
+            if (lhsLevel < rhsLevel)
+            {
+                node_t* const next
+                    = id_inc_ref_count(this->nonsup_impl(son, rhs));
+                release(son);
+                son = next;
+            }
+            else
+            {
+                for (int32 j = 0; j <= k; ++j)
+                {
+                    node_t* const next = id_inc_ref_count(
+                        this->nonsup_impl(son, rhs->get_son(j))
+                    );
+                    release(son);
+                    son = next;
+                }
+            }
+            sons[k] = son;
+        }
+        disown_sons(sons, domain);
+        result = nodes_.make_zero_suppressed_node(index, sons);
+    }
+
+    nodes_.template cache_put<details::zdd_nonsup>(result, lhs, rhs);
+    return result;
+}
+
+template<class Degree, class Domain>
+auto zdd_manager<Degree, Domain>::contains_zero(node_t* node) -> bool
+{
+    while (not node->is_terminal())
+    {
+        node = node->get_son(0);
+    }
+    return node->get_value() == 1;
+}
+
+template<class Degree, class Domain>
+auto zdd_manager<Degree, Domain>::release(node_t* const node) -> void
+{
+    // Intermediate result that is not used as a son of any node
+    // must not stay marked, otherwise it would never be collected.
+    node->dec_ref_count();
+    node->set_notmarked();
+}
+
+template<class Degree, class Domain>
+auto zdd_manager<Degree, Domain>::disown_sons(
+    son_container const& sons,
+    int32 const domain
+) -> void
+{
+    // Sons are referenced while intermediate results are released
+    // so that they can't be collected. Afterwards, they are just
+    // marked as any other result waiting to become a son of a node.
+    for (int32 k = 0; k < domain; ++k)
+    {
+        sons[k]->dec_ref_count();
+        sons[k]->set_marked();
+    }
+}
+
+template<class Degree, class Domain>
+auto zdd_manager<Degree, Domain>::make_result(node_t* const root) -> diagram_t
+{
+    diagram_t result(root);
+    // Terminal 0 is used as an operand of the recursive
+    // operations and might have been left marked.
+    nodes_.for_each_terminal_node(id_set_notmarked<void, Degree>);
+    return result;
+}
+
+template<class Degree, class Domain>
+template<class Vars, class OutputIt>
+auto zdd_manager<Degree, Domain>::enumerate_impl(
+    Vars& vars,
+    OutputIt& out,
+    node_t* const node
+) const -> void
+{
+    if (node->is_terminal())
+    {
+        if (node->get_value() == 1)
+        {
+            *out++ = vars;
+        }
+        return;
+    }
+
+    int32 const index  = node->get_index();
+    int32 const domain = nodes_.get_domain(index);
+    for (int32 k = 0; k < domain; ++k)
+    {
+        vars[as_uindex(index)] = k;
+        this->enumerate_impl(vars, out, node->get_son(k));
+    }
+    vars[as_uindex(index)] = 0;
+}
+} // namespace teddy
+
+#endif
@@ -12,8 +12,15 @@
 
 #include <fmt/core.h>
 
+#include <algorithm>
 #include <concepts>
 #include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+#include <sstream>
 
 #include "libteddy/details/operators.hpp"
 #include "libteddy/details/types.hpp"
@@ -200,6 +207,265 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(evaluate, Fixture, Fixtures, Fixture)
     auto domainit = make_domain_iterator(manager);
     auto evalit   = teddy::tsl::evaluating_iterator(domainit, expr);
     test_compare_eval(evalit, manager, diagram);
+
+    auto assignments = std::vector<std::vector<int32>>();
+    auto expected    = std::vector<int32>();
+    auto evalEnd     = tsl::evaluating_iterator_sentinel();
+    auto batchit     = teddy::tsl::evaluating_iterator(
+        make_domain_iterator(manager),
+        expr
+    );
+    while (batchit != evalEnd)
+    {
+        assignments.push_back(batchit.get_var_vals());
+        expected.push_back(*batchit);
+        ++batchit;
+    }
+    auto actual = std::vector<int32>();
+    manager.evaluate_batch(diagram, assignments, std::back_inserter(actual));
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(
+        actual.begin(),
+        actual.end(),
+        expected.begin(),
+        expected.end()
+    );
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(diagram_image, Fixture, Fixtures, Fixture)
+{
+    auto expr    = make_expression(Fixture::expressionSettings_, Fixture::rng_);
+    auto manager = make_manager(Fixture::managerSettings_, Fixture::rng_);
+    auto diagram = tsl::make_diagram(expr, manager);
+    auto image   = manager.make_image(diagram);
+    BOOST_REQUIRE_EQUAL(
+        image.get_node_count(),
+        manager.get_node_count(diagram)
+    );
+
+    auto evalit  = teddy::tsl::evaluating_iterator(
+        make_domain_iterator(manager),
+        expr
+    );
+    auto evalEnd = tsl::evaluating_iterator_sentinel();
+    while (evalit != evalEnd)
+    {
+        BOOST_REQUIRE_EQUAL(*evalit, image.evaluate(evalit.get_var_vals()));
+        ++evalit;
+    }
+
+    // Uniform probabilities turn counts into probabilities.
+    auto const domains = manager.get_domains();
+    auto probs         = std::vector<std::vector<double>>();
+    auto totalCount    = 1.0;
+    for (auto const domain : domains)
+    {
+        probs.emplace_back(as_usize(domain), 1.0 / domain);
+        totalCount *= domain;
+    }
+
+    auto expected = expected_counts(manager, expr);
+    for (auto k = 0; k < ssize(expected); ++k)
+    {
+        BOOST_REQUIRE_EQUAL(image.satisfy_count(k), expected[as_uindex(k)]);
+        BOOST_TEST(
+            image.calculate_probability(k, probs)
+                == static_cast<double>(expected[as_uindex(k)]) / totalCount,
+            boost::test_tools::tolerance(1e-9)
+        );
+    }
+
+    auto dependencies = image.get_dependency_set();
+    auto expectedDeps = manager.get_dependency_set(diagram);
+    std::sort(dependencies.begin(), dependencies.end());
+    std::sort(expectedDeps.begin(), expectedDeps.end());
+    BOOST_REQUIRE(dependencies == expectedDeps);
+
+    // Opened image views the memory-mapped file.
+    auto const path
+        = std::filesystem::temp_directory_path() / "libteddy-image.bin";
+    {
+        auto ost = std::ofstream(path, std::ios::binary);
+        image.save(ost);
+    }
+    auto const opened = teddy::diagram_image::open(path.string());
+    BOOST_REQUIRE(opened.has_value());
+    BOOST_REQUIRE_EQUAL(opened->get_node_count(), image.get_node_count());
+    BOOST_REQUIRE(opened->get_dependency_set() == image.get_dependency_set());
+    for (auto k = 0; k < ssize(expected); ++k)
+    {
+        BOOST_REQUIRE_EQUAL(opened->satisfy_count(k), expected[as_uindex(k)]);
+    }
+    auto openedit = teddy::tsl::evaluating_iterator(
+        make_domain_iterator(manager),
+        expr
+    );
+    while (openedit != evalEnd)
+    {
+        BOOST_REQUIRE_EQUAL(
+            *openedit,
+            opened->evaluate(openedit.get_var_vals())
+        );
+        ++openedit;
+    }
+
+    // Son count that wraps the total size to the size of the file.
+    {
+        auto sst = std::stringstream();
+        image.save(sst);
+        auto bytes    = sst.str();
+        auto offset   = 2 * sizeof(uint64) + 2 * sizeof(int32);
+        auto sonCount = uint64 {};
+        std::memcpy(&sonCount, bytes.data() + offset, sizeof(sonCount));
+        sonCount += uint64 {1} << 62;
+        std::memcpy(bytes.data() + offset, &sonCount, sizeof(sonCount));
+        auto ost = std::ofstream(path, std::ios::binary);
+        ost << bytes;
+    }
+    BOOST_REQUIRE(not teddy::diagram_image::open(path.string()).has_value());
+
+    // Corrupted content with a valid size.
+    auto saved = std::stringstream();
+    image.save(saved);
+    auto const bytes     = saved.str();
+    auto const varCount  = as_usize(image.get_var_count());
+    auto const nodeCount = as_usize(image.get_node_count());
+    auto const levelsAt  = 3 * sizeof(uint64) + 2 * sizeof(int32)
+                        + varCount * sizeof(int32);
+    auto const nodesAt   = levelsAt + varCount * sizeof(int32);
+    auto const sonsAt    = nodesAt + nodeCount * 2 * sizeof(int32);
+    auto const read      = [&bytes] (std::size_t const at)
+    {
+        auto value = int32 {};
+        std::memcpy(&value, bytes.data() + at, sizeof(value));
+        return value;
+    };
+    auto const isRejected = [&bytes, &path] (std::size_t at, int32 value)
+    {
+        auto corrupted = bytes;
+        std::memcpy(corrupted.data() + at, &value, sizeof(value));
+        {
+            auto ost = std::ofstream(path, std::ios::binary);
+            ost << corrupted;
+        }
+        return not teddy::diagram_image::open(path.string()).has_value();
+    };
+    if (varCount > 1)
+    {
+        // Levels are not a permutation.
+        BOOST_REQUIRE(isRejected(levelsAt + sizeof(int32), read(levelsAt)));
+    }
+    if (nodeCount > 1)
+    {
+        // Root is an internal node.
+        auto const sonCount = (bytes.size() - sonsAt) / sizeof(int32);
+        auto const sonAt
+            = sonsAt + as_usize(read(nodesAt + sizeof(int32))) * sizeof(int32);
+        BOOST_REQUIRE(isRejected(nodesAt, static_cast<int32>(varCount)));
+        BOOST_REQUIRE(isRejected(
+            nodesAt + sizeof(int32),
+            static_cast<int32>(sonCount)
+        ));
+        BOOST_REQUIRE(isRejected(sonAt, 0));
+        BOOST_REQUIRE(isRejected(sonAt, static_cast<int32>(nodeCount)));
+    }
+
+    {
+        auto ost = std::ofstream(path, std::ios::binary);
+        ost << "not an image";
+    }
+    BOOST_REQUIRE(not teddy::diagram_image::open(path.string()).has_value());
+    std::filesystem::remove(path);
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(save_load, Fixture, Fixtures, Fixture)
+{
+    // Same rng state gives both managers the same order and domains.
+    auto otherRng = Fixture::rng_;
+    auto manager  = make_manager(Fixture::managerSettings_, Fixture::rng_);
+    auto other    = make_manager(Fixture::managerSettings_, otherRng);
+    auto expr = make_expression(Fixture::expressionSettings_, Fixture::rng_);
+    auto diagram  = tsl::make_diagram(expr, manager);
+    auto cofactor = manager.get_cofactor(diagram, 0, 1);
+
+    auto buffer = std::stringstream();
+    manager.save({diagram, cofactor, diagram}, buffer);
+    auto const bytes = buffer.str();
+
+    auto const loaded = other.load(buffer);
+    BOOST_REQUIRE(loaded.has_value());
+    BOOST_REQUIRE_EQUAL(ssize(*loaded), 3);
+    BOOST_REQUIRE_EQUAL(
+        other.get_node_count((*loaded)[0]),
+        manager.get_node_count(diagram)
+    );
+    BOOST_REQUIRE_EQUAL(
+        other.get_node_count((*loaded)[1]),
+        manager.get_node_count(cofactor)
+    );
+    BOOST_REQUIRE((*loaded)[0].equals((*loaded)[2]));
+
+    auto evalit  = teddy::tsl::evaluating_iterator(
+        make_domain_iterator(manager),
+        expr
+    );
+    auto evalEnd = tsl::evaluating_iterator_sentinel();
+    while (evalit != evalEnd)
+    {
+        auto const& vars = evalit.get_var_vals();
+        BOOST_REQUIRE_EQUAL(*evalit, other.evaluate((*loaded)[0], vars));
+        BOOST_REQUIRE_EQUAL(
+            manager.evaluate(cofactor, vars),
+            other.evaluate((*loaded)[1], vars)
+        );
+        ++evalit;
+    }
+
+    // Loading into the same manager finds the existing nodes.
+    auto same = std::stringstream(bytes);
+    auto const reloaded = manager.load(same);
+    BOOST_REQUIRE(reloaded.has_value());
+    BOOST_REQUIRE((*reloaded)[0].equals(diagram));
+    BOOST_REQUIRE((*reloaded)[1].equals(cofactor));
+
+    auto truncated = std::stringstream(bytes.substr(0, bytes.size() / 2));
+    BOOST_REQUIRE(not other.load(truncated).has_value());
+    auto empty = std::stringstream();
+    BOOST_REQUIRE(not other.load(empty).has_value());
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(transfer, Fixture, Fixtures, Fixture)
+{
+    // Same rng state gives both managers the same domains, the order
+    // of the target manager is reversed.
+    auto otherRng      = Fixture::rng_;
+    auto otherSettings = Fixture::managerSettings_;
+    auto manager       = make_manager(Fixture::managerSettings_, Fixture::rng_);
+    auto order         = manager.get_order();
+    std::reverse(order.begin(), order.end());
+    otherSettings.order_ = given_order_tag {order};
+    auto other           = make_manager(otherSettings, otherRng);
+    BOOST_REQUIRE(other.get_domains() == manager.get_domains());
+
+    auto expr = make_expression(Fixture::expressionSettings_, Fixture::rng_);
+    auto diagram        = tsl::make_diagram(expr, manager);
+    auto const expected  = tsl::make_diagram(expr, other);
+    auto const nodeCount = other.get_node_count(expected);
+    auto const imported  = other.transfer(diagram, manager);
+    BOOST_REQUIRE(imported.equals(expected));
+    BOOST_REQUIRE_EQUAL(other.get_node_count(imported), nodeCount);
+
+    // Importing back gives the original diagram.
+    auto const back = manager.transfer(imported, other);
+    BOOST_REQUIRE(back.equals(diagram));
+}
+
+BOOST_AUTO_TEST_CASE(save_load_order_mismatch)
+{
+    auto manager = bdd_manager(3, 1'000);
+    auto other   = bdd_manager(3, 1'000, {2, 1, 0});
+    auto buffer  = std::stringstream();
+    manager.save({manager.variable(0)}, buffer);
+    BOOST_REQUIRE(not other.load(buffer).has_value());
 }
 
 BOOST_FIXTURE_TEST_CASE_TEMPLATE(fold, Fixture, Fixtures, Fixture)
@@ -249,6 +515,177 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(satisfy_count, Fixture, Fixtures, Fixture)
     {
         BOOST_REQUIRE_EQUAL(actual[as_uindex(k)], expected[as_uindex(k)]);
     }
+
+    for (auto j = 0; j < ssize(actual); ++j)
+    {
+        using wide_t    = big_uint<4>;
+        auto const wide = manager.template satisfy_count<wide_t>(j, diagram);
+        auto const real = manager.template satisfy_count<double>(j, diagram);
+        auto const expectedCount = expected[as_uindex(j)];
+        BOOST_REQUIRE(wide == wide_t(expectedCount));
+        BOOST_REQUIRE_EQUAL(real, static_cast<double>(expectedCount));
+    }
+
+    auto const counts = manager.satisfy_counts(diagram);
+    for (auto j = 0; j < ssize(expected); ++j)
+    {
+        auto const count = j < ssize(counts) ? counts[as_uindex(j)] : 0;
+        BOOST_REQUIRE_EQUAL(count, expected[as_uindex(j)]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(from_pla)
+{
+    auto const path
+        = std::filesystem::temp_directory_path() / "libteddy-from-pla.pla";
+    {
+        auto ost = std::ofstream(path);
+        ost << ".i 4\n"
+            << ".o 2\n"
+            << ".p 4\n"
+            << "1-0- 10\n"
+            << "-11- 11\n"
+            << "# comment\r\n"
+            << "0--1 01\r\n"
+            << "---- 00\n"
+            << ".e\n";
+    }
+    auto const file = teddy::pla_file::load_file(path.string());
+    BOOST_REQUIRE(file.has_value());
+    BOOST_REQUIRE_EQUAL(file->get_line_count(), 4);
+
+    auto lineCount    = 0;
+    auto const header = teddy::pla_file::scan_file(
+        path.string(),
+        [&lineCount] (teddy::pla_file::pla_line const&) { ++lineCount; }
+    );
+    BOOST_REQUIRE(header.has_value());
+    BOOST_REQUIRE_EQUAL(header->varCount_, 4);
+    BOOST_REQUIRE_EQUAL(header->functionCount_, 2);
+    BOOST_REQUIRE_EQUAL(lineCount, 4);
+
+    // Reversed order so that levels differ from indices.
+    auto manager        = teddy::bdd_manager(4, 1'000, {3, 2, 1, 0});
+    auto const streamed = manager.from_pla_file(path.string());
+    std::filesystem::remove(path);
+    BOOST_REQUIRE(streamed.has_value());
+    BOOST_REQUIRE(not manager.from_pla_file(path.string()).has_value());
+    for (auto const foldType : {fold_type::Left, fold_type::Tree})
+    {
+        auto const diagrams = manager.from_pla(*file, foldType);
+        BOOST_REQUIRE_EQUAL(ssize(diagrams), 2);
+        for (auto i = 0; i < 16; ++i)
+        {
+            auto const x = std::vector<int32> {
+                i & 1,
+                (i >> 1) & 1,
+                (i >> 2) & 1,
+                (i >> 3) & 1
+            };
+            auto const f0 = (x[0] && not x[2]) || (x[1] && x[2]);
+            auto const f1 = (x[1] && x[2]) || (not x[0] && x[3]);
+            BOOST_REQUIRE_EQUAL(manager.evaluate(diagrams[0], x), f0);
+            BOOST_REQUIRE_EQUAL(manager.evaluate(diagrams[1], x), f1);
+        }
+        BOOST_REQUIRE(diagrams[0].equals((*streamed)[0]));
+        BOOST_REQUIRE(diagrams[1].equals((*streamed)[1]));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(from_pla_long_lines)
+{
+    // Lines longer than the read buffer and no line break at the end.
+    auto const varCount = 100'000;
+    auto const path
+        = std::filesystem::temp_directory_path() / "libteddy-long-lines.pla";
+    {
+        auto ost = std::ofstream(path);
+        ost << ".i " << varCount << "\n"
+            << ".o 1\n"
+            << ".p 3\n"
+            << std::string(as_usize(varCount), '1') << " 1\n"
+            << std::string(as_usize(varCount), '-') << " 0\n"
+            << std::string(as_usize(varCount), '0') << " 1";
+    }
+
+    auto lineCount    = 0;
+    auto dontCares    = 0;
+    auto const header = teddy::pla_file::scan_file(
+        path.string(),
+        [&lineCount, &dontCares, varCount] (
+            teddy::pla_file::pla_line const& line
+        )
+        {
+            ++lineCount;
+            BOOST_REQUIRE_EQUAL(line.cube_.size(), varCount);
+            if (line.cube_.get(varCount - 1) == teddy::bool_cube::DontCare)
+            {
+                ++dontCares;
+            }
+        }
+    );
+    std::filesystem::remove(path);
+    BOOST_REQUIRE(header.has_value());
+    BOOST_REQUIRE_EQUAL(header->varCount_, varCount);
+    BOOST_REQUIRE_EQUAL(lineCount, 3);
+    BOOST_REQUIRE_EQUAL(dontCares, 1);
+}
+
+BOOST_AUTO_TEST_CASE(bool_cube_operations)
+{
+    // Spans multiple words.
+    auto const size = 100;
+    auto lhs        = teddy::bool_cube(size);
+    auto rhs        = teddy::bool_cube(size);
+    for (auto i = 0; i < size; ++i)
+    {
+        BOOST_REQUIRE_EQUAL(lhs.get(i), 0);
+        lhs.set(i, teddy::bool_cube::DontCare);
+        rhs.set(i, teddy::bool_cube::DontCare);
+    }
+
+    lhs.set(3, 1);
+    lhs.set(70, 0);
+    rhs.set(3, 1);
+    rhs.set(70, 0);
+    rhs.set(99, 1);
+    BOOST_REQUIRE_EQUAL(rhs.get(99), 1);
+    BOOST_REQUIRE_EQUAL(rhs.get(98), teddy::bool_cube::DontCare);
+    BOOST_REQUIRE(lhs.contains(rhs));
+    BOOST_REQUIRE(not rhs.contains(lhs));
+    BOOST_REQUIRE(lhs.intersects(rhs));
+    BOOST_REQUIRE_EQUAL(lhs.distance(rhs), 0);
+    BOOST_REQUIRE(lhs.intersection(rhs) == rhs);
+
+    lhs.set(99, 0);
+    lhs.set(70, 1);
+    BOOST_REQUIRE(not lhs.contains(rhs));
+    BOOST_REQUIRE(not lhs.intersects(rhs));
+    BOOST_REQUIRE_EQUAL(lhs.distance(rhs), 2);
+    BOOST_REQUIRE(not lhs.intersection(rhs).has_value());
+
+    lhs.set(70, teddy::bool_cube::DontCare);
+    lhs.set(99, teddy::bool_cube::DontCare);
+    rhs.set(3, teddy::bool_cube::DontCare);
+    rhs.set(70, teddy::bool_cube::DontCare);
+    rhs.set(99, teddy::bool_cube::DontCare);
+    rhs.set(3, 1);
+    BOOST_REQUIRE(lhs == rhs);
+}
+
+BOOST_AUTO_TEST_CASE(satisfy_count_wide)
+{
+    auto manager        = bdd_manager(100, 1'000);
+    auto const diagram  = manager.variable(0);
+    auto const expected = std::string("633825300114114700748351602688");
+    BOOST_REQUIRE_EQUAL(
+        manager.satisfy_count<big_uint<4>>(1, diagram).to_string(),
+        expected
+    );
+    BOOST_REQUIRE_EQUAL(
+        manager.satisfy_count<double>(1, diagram),
+        std::ldexp(1.0, 99)
+    );
 }
 
 BOOST_FIXTURE_TEST_CASE_TEMPLATE(satisfy_one, Fixture, Fixtures, Fixture)
@@ -304,6 +741,198 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(satisfy_all, Fixture, Fixtures, Fixture)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(satisfy_range, Fixture, Fixtures, Fixture)
+{
+    auto expr    = make_expression(Fixture::expressionSettings_, Fixture::rng_);
+    auto manager = make_manager(Fixture::managerSettings_, Fixture::rng_);
+    auto diagram = tsl::make_diagram(expr, manager);
+    BOOST_TEST_MESSAGE(
+        fmt::format("Node count {}", manager.get_node_count(diagram))
+    );
+    auto const domains = manager.get_domains();
+    auto expected      = expected_counts(manager, expr);
+    for (auto k = 0; k < ssize(expected); ++k)
+    {
+        auto assignmentCount = int64 {0};
+        for (auto const& vars : manager.satisfy_range(k, diagram))
+        {
+            BOOST_REQUIRE_EQUAL(k, manager.evaluate(diagram, vars));
+            ++assignmentCount;
+        }
+        BOOST_REQUIRE_EQUAL(assignmentCount, expected[as_uindex(k)]);
+
+        auto cubeCount    = int64 {0};
+        auto coveredCount = int64 {0};
+        auto const cubes
+            = manager.satisfy_range(k, diagram, teddy::satisfy_mode::Cubes);
+        for (auto const& cube : cubes)
+        {
+            auto vars     = cube;
+            auto cubeSize = int64 {1};
+            for (auto i = 0; i < ssize(vars); ++i)
+            {
+                if (vars[as_uindex(i)] == teddy::DontCare)
+                {
+                    vars[as_uindex(i)]  = 0;
+                    cubeSize           *= domains[as_uindex(i)];
+                }
+            }
+            BOOST_REQUIRE_EQUAL(k, manager.evaluate(diagram, vars));
+            coveredCount += cubeSize;
+            ++cubeCount;
+        }
+        BOOST_REQUIRE_LE(cubeCount, assignmentCount);
+        BOOST_REQUIRE_EQUAL(coveredCount, expected[as_uindex(k)]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(satisfy_range_pruned)
+{
+    // Parity of x1 ... x30 never evaluates to 2. Enumeration must not
+    // walk through its 3^30 paths to find that out.
+    using namespace teddy::ops;
+    auto manager = mdd_manager<3>(31, 10'000);
+    auto vars    = std::vector<mdd_manager<3>::diagram_t>();
+    for (auto i = 1; i < 31; ++i)
+    {
+        vars.push_back(manager.variable(i));
+    }
+    auto const parity  = manager.left_fold<PLUS<2>>(vars);
+    auto const diagram = manager.multiplex(
+        manager.variable(0),
+        {parity, parity, manager.constant(2)}
+    );
+
+    auto const empty = manager.satisfy_range(2, parity);
+    BOOST_REQUIRE(empty.begin() == empty.end());
+
+    auto resultCount = 0;
+    for (auto const& values : manager.satisfy_range(2, diagram))
+    {
+        BOOST_REQUIRE_EQUAL(values[0], 2);
+        if (++resultCount == 3)
+        {
+            break;
+        }
+    }
+    BOOST_REQUIRE_EQUAL(resultCount, 3);
+}
+
+BOOST_AUTO_TEST_CASE(satisfy_range_interleaved)
+{
+    using namespace teddy::ops;
+    auto manager = bdd_manager(3, 1'000);
+
+    auto constantCount = 0;
+    for ([[maybe_unused]] auto const& values :
+         manager.satisfy_range(1, manager.constant(1)))
+    {
+        ++constantCount;
+    }
+    BOOST_REQUIRE_EQUAL(constantCount, 8);
+
+    // Other traversals between increments must not disturb iterators.
+    auto const f
+        = manager.apply<OR>(manager.variable(0), manager.variable(2));
+    auto const g
+        = manager.apply<AND>(manager.variable(1), manager.variable(2));
+    auto const fRange = manager.satisfy_range(1, f);
+    auto const gRange = manager.satisfy_range(0, g);
+    auto fIt          = fRange.begin();
+    auto gIt          = gRange.begin();
+    auto fCount       = int64 {0};
+    auto gCount       = int64 {0};
+    while (fIt != fRange.end() || gIt != gRange.end())
+    {
+        if (fIt != fRange.end())
+        {
+            BOOST_REQUIRE_EQUAL(manager.evaluate(f, *fIt), 1);
+            ++fCount;
+            ++fIt;
+        }
+        static_cast<void>(manager.satisfy_count(1, g));
+        if (gIt != gRange.end())
+        {
+            BOOST_REQUIRE_EQUAL(manager.evaluate(g, *gIt), 0);
+            ++gCount;
+            ++gIt;
+        }
+        static_cast<void>(manager.get_node_count(f));
+    }
+    BOOST_REQUIRE_EQUAL(fCount, manager.satisfy_count(1, f));
+    BOOST_REQUIRE_EQUAL(gCount, manager.satisfy_count(0, g));
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(sample_satisfying, Fixture, Fixtures, Fixture)
+{
+    auto expr    = make_expression(Fixture::expressionSettings_, Fixture::rng_);
+    auto manager = make_manager(Fixture::managerSettings_, Fixture::rng_);
+    auto diagram = tsl::make_diagram(expr, manager);
+
+    auto expected = expected_counts(manager, expr);
+    for (auto k = 0; k < ssize(expected); ++k)
+    {
+        auto const samples
+            = manager.sample_satisfying(k, diagram, Fixture::rng_, 100);
+        BOOST_REQUIRE_EQUAL(ssize(samples), expected[as_uindex(k)] ? 100 : 0);
+        for (auto const& vars : samples)
+        {
+            BOOST_REQUIRE_EQUAL(k, manager.evaluate(diagram, vars));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sample_satisfying_uniform)
+{
+    // x0 or x1 has 6 satisfying assignments, x2 is free.
+    auto manager       = teddy::bdd_manager(3, 100);
+    auto rng           = std::ranlux48(5489);
+    auto const diagram = manager.apply<teddy::ops::OR>(
+        manager.variable(0),
+        manager.variable(1)
+    );
+    auto const samples = manager.sample_satisfying(1, diagram, rng, 6'000);
+    auto frequencies   = std::map<std::vector<int32>, int64>();
+    for (auto const& vars : samples)
+    {
+        ++frequencies[vars];
+    }
+    BOOST_REQUIRE_EQUAL(ssize(frequencies), 6);
+    for (auto const& [vars, frequency] : frequencies)
+    {
+        BOOST_REQUIRE_EQUAL(1, manager.evaluate(diagram, vars));
+        BOOST_REQUIRE_GT(frequency, 800);
+        BOOST_REQUIRE_LT(frequency, 1'200);
+    }
+
+    auto const none = manager.sample_satisfying(1, manager.constant(0), rng, 5);
+    BOOST_REQUIRE(none.empty());
+}
+
+BOOST_AUTO_TEST_CASE(sample_satisfying_deep)
+{
+    // Probability of the only satisfying assignment is 2^-1100 which
+    // is below the smallest positive double.
+    using namespace teddy::ops;
+    auto manager = bdd_manager(1'100, 10'000);
+    auto vars    = std::vector<bdd_manager::diagram_t>();
+    for (auto i = 0; i < manager.get_var_count(); ++i)
+    {
+        vars.push_back(manager.variable(i));
+    }
+    auto const diagram = manager.left_fold<AND>(vars);
+    auto rng           = std::ranlux48(5);
+    auto const samples = manager.sample_satisfying(1, diagram, rng, 3);
+    BOOST_REQUIRE_EQUAL(ssize(samples), 3);
+    for (auto const& sample : samples)
+    {
+        BOOST_REQUIRE(std::ranges::all_of(
+            sample,
+            [] (int32 const value) { return value == 1; }
+        ));
+    }
+}
+
 BOOST_FIXTURE_TEST_CASE_TEMPLATE(operators_1, Fixture, Fixtures, Fixture)
 {
     using namespace teddy::ops;
@@ -745,6 +1374,63 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(cofactor, Fixture, Fixtures, Fixture)
     test_compare_eval(evalIt, manager, cofactoredDiagram1);
     test_compare_eval(evalIt, manager, cofactoredDiagram2);
     BOOST_REQUIRE(cofactoredDiagram1.equals(cofactoredDiagram2));
+
+    manager.force_gc();
+    auto const cofactoredDiagram3
+        = manager.get_cofactor(intermediateDiagram, index2, value2);
+    BOOST_REQUIRE(cofactoredDiagram1.equals(cofactoredDiagram3));
+}
+
+BOOST_AUTO_TEST_CASE(cofactor_reorder)
+{
+    // Sifting frees nodes whose addresses the small pool reuses,
+    // cached cofactors must not survive it.
+    auto manager = bdd_manager(10, 100);
+    auto rng     = std::ranlux48(17);
+    auto bitDist = std::uniform_int_distribution<int32>(0, 1);
+    for (auto trial = 0; trial < 10; ++trial)
+    {
+        auto vector = std::vector<int32>(1'024);
+        for (auto& value : vector)
+        {
+            value = bitDist(rng);
+        }
+        auto const diagram = manager.from_vector(vector);
+        for (auto j = 0; j < manager.get_var_count(); ++j)
+        {
+            static_cast<void>(manager.get_cofactor(diagram, j, 1));
+        }
+        manager.force_reorder();
+
+        auto values = std::vector<int32>(10);
+        for (auto j = 0; j < manager.get_var_count(); ++j)
+        {
+            auto const cofactor = manager.get_cofactor(diagram, j, 1);
+            for (auto i = 0; i < 1'024; ++i)
+            {
+                for (auto k = 0; k < 10; ++k)
+                {
+                    values[as_uindex(k)] = (i >> k) & 1;
+                }
+                values[as_uindex(j)] = 1;
+                BOOST_REQUIRE_EQUAL(
+                    manager.evaluate(cofactor, values),
+                    manager.evaluate(diagram, values)
+                );
+            }
+        }
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(transform, Fixture, Fixtures, Fixture)
+{
+    auto expr    = make_expression(Fixture::expressionSettings_, Fixture::rng_);
+    auto manager = make_manager(Fixture::managerSettings_, Fixture::rng_);
+    auto diagram = tsl::make_diagram(expr, manager);
+    auto zero    = manager.transform(diagram, [] (int32) { return 0; });
+    auto same    = manager.transform(diagram, [] (int32 val) { return val; });
+    BOOST_REQUIRE(zero.equals(manager.constant(0)));
+    BOOST_REQUIRE(same.equals(diagram));
 }
 
 BOOST_FIXTURE_TEST_CASE_TEMPLATE(one_var_sift, Fixture, Fixtures, Fixture)
@@ -800,6 +1486,22 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(from_vector, Fixture, Fixtures, Fixture)
     );
 }
 
+BOOST_AUTO_TEST_CASE(from_vector_runs)
+{
+    // Long constant runs with a few isolated changes.
+    auto manager = mdd_manager<3>(10, 1'000);
+    auto vector  = std::vector<int32>(59'049, 0);
+    std::fill(vector.begin() + 19'683, vector.begin() + 39'366, 2);
+    vector[100]    = 1;
+    vector[40'000] = 1;
+    vector[59'048] = 2;
+    auto const diagram = manager.from_vector(vector);
+    BOOST_REQUIRE(manager.to_vector(diagram) == vector);
+
+    auto constant = std::vector<int32>(59'049, 1);
+    BOOST_REQUIRE(manager.from_vector(constant).equals(manager.constant(1)));
+}
+
 BOOST_FIXTURE_TEST_CASE_TEMPLATE(to_vector, Fixture, Fixtures, Fixture)
 {
     auto expr    = make_expression(Fixture::expressionSettings_, Fixture::rng_);
@@ -814,6 +1516,10 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(to_vector, Fixture, Fixtures, Fixture)
         diagram.equals(vectord),
         "From-vector from to-vectored vector created the same diagram"
     );
+
+    auto evaluated = std::vector<int32>();
+    manager.to_vector_g(diagram, std::back_inserter(evaluated));
+    BOOST_REQUIRE(vector == evaluated);
 }
 
 BOOST_FIXTURE_TEST_CASE_TEMPLATE(from_expression, Fixture, Fixtures, Fixture)
@@ -830,5 +1536,296 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(from_expression, Fixture, Fixtures, Fixture)
     test_compare_eval(evalit, manager, diagram);
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(apply_n, Fixture, Fixtures, Fixture)
+{
+    auto manager = make_manager(Fixture::managerSettings_, Fixture::rng_);
+    auto expr1   = make_expression(Fixture::expressionSettings_, Fixture::rng_);
+    auto expr2   = make_expression(Fixture::expressionSettings_, Fixture::rng_);
+    auto diagram1 = tsl::make_diagram(expr1, manager);
+    auto diagram2 = tsl::make_diagram(expr2, manager);
+    auto diagram3 = manager.variable(0);
+    auto expected = manager.template apply<ops::MIN>(
+        manager.template apply<ops::MIN>(diagram1, diagram2),
+        diagram3
+    );
+    auto actual1
+        = manager.template apply_n<ops::MIN>(diagram1, diagram2, diagram3);
+    manager.force_gc();
+    auto actual2
+        = manager.template apply_n<ops::MIN>(diagram1, diagram2, diagram3);
+    auto actual3 = manager.template apply_n<ops::MIN>(diagram1, diagram2);
+    BOOST_REQUIRE(expected.equals(actual1));
+    BOOST_REQUIRE(expected.equals(actual2));
+    BOOST_REQUIRE(
+        actual3.equals(manager.template apply<ops::MIN>(diagram1, diagram2))
+    );
+}
+
+BOOST_FIXTURE_TEST_CASE(ite, bdd_fixture)
+{
+    using namespace teddy::ops;
+    auto manager = make_manager(managerSettings_, rng_);
+    auto expr1   = make_expression(expressionSettings_, rng_);
+    auto expr2   = make_expression(expressionSettings_, rng_);
+    auto expr3   = make_expression(expressionSettings_, rng_);
+    auto f       = tsl::make_diagram(expr1, manager);
+    auto g       = tsl::make_diagram(expr2, manager);
+    auto h       = tsl::make_diagram(expr3, manager);
+    auto expected = manager.apply<OR>(
+        manager.apply<AND>(f, g),
+        manager.apply<AND>(manager.negate(f), h)
+    );
+    auto actual1 = manager.ite(f, g, h);
+    manager.force_gc();
+    auto actual2 = manager.ite(f, g, h);
+    BOOST_REQUIRE(expected.equals(actual1));
+    BOOST_REQUIRE(expected.equals(actual2));
+    BOOST_REQUIRE(manager.ite(f, f, h).equals(manager.apply<OR>(f, h)));
+    BOOST_REQUIRE(manager.ite(f, g, f).equals(manager.apply<AND>(f, g)));
+    BOOST_REQUIRE(
+        manager.ite(f, manager.constant(1), manager.constant(0)).equals(f)
+    );
+    BOOST_REQUIRE(manager.ite(f, g, g).equals(g));
+    BOOST_REQUIRE(manager.ite(manager.constant(0), g, h).equals(h));
+}
+
+BOOST_AUTO_TEST_CASE(multiplex)
+{
+    using namespace teddy::ops;
+    auto manager  = mdd_manager<3>(6, 1'000);
+    auto selector
+        = manager.apply<MAX>(manager.variable(0), manager.variable(3));
+    auto cases = std::vector<mdd_manager<3>::diagram_t> {
+        manager.apply<MIN>(manager.variable(1), manager.variable(4)),
+        selector,
+        manager.apply<PLUS<3>>(manager.variable(2), manager.variable(5))};
+    auto const diagram = manager.multiplex(selector, cases);
+
+    auto values = std::vector<int32>(6, 0);
+    for (int32 i = 0; i < 729; ++i)
+    {
+        int32 rest = i;
+        for (int32& value : values)
+        {
+            value  = rest % 3;
+            rest  /= 3;
+        }
+        int32 const k = manager.evaluate(selector, values);
+        BOOST_REQUIRE_EQUAL(
+            manager.evaluate(diagram, values),
+            manager.evaluate(cases[as_uindex(k)], values)
+        );
+    }
+
+    auto const same = std::vector {cases[0], cases[0], cases[0]};
+    BOOST_REQUIRE(manager.multiplex(selector, same).equals(cases[0]));
+}
+
+BOOST_AUTO_TEST_CASE(multiplex_marks)
+{
+    using namespace teddy::ops;
+    auto manager = bdd_manager(2, 100);
+    auto const f
+        = manager.apply<AND>(manager.variable(0), manager.variable(1));
+    auto const nodes   = manager.get_node_count(f);
+    auto const count   = manager.satisfy_count(1, f);
+    auto const zero    = manager.constant(0);
+    auto const one     = manager.constant(1);
+    auto const results = std::vector {
+        manager.ite(f, f, zero),
+        manager.ite(f, one, f),
+        manager.multiplex(f, {zero, f})};
+    for (auto const& result : results)
+    {
+        BOOST_REQUIRE(result.equals(f));
+        BOOST_REQUIRE_EQUAL(manager.get_node_count(f), nodes);
+        BOOST_REQUIRE_EQUAL(manager.satisfy_count(1, f), count);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(complement_edges, bdd_fixture)
+{
+    using namespace teddy::ops;
+    auto expr    = make_expression(expressionSettings_, rng_);
+    auto manager = make_manager(managerSettings_, rng_);
+    auto diagram = tsl::make_diagram(expr, manager);
+    auto cmanager = cbdd_manager(
+        manager.get_var_count(),
+        managerSettings_.nodecount_,
+        manager.get_order()
+    );
+    std::vector<cbdd_manager::diagram_t> terms;
+    for (auto const& eTerm : expr.terms_)
+    {
+        auto vars = cmanager.variables(eTerm);
+        terms.push_back(cmanager.left_fold<AND>(vars));
+    }
+    auto const cdiagram = cmanager.tree_fold<OR>(terms);
+    BOOST_TEST_MESSAGE(fmt::format(
+        "Node count {} vs {}",
+        manager.get_node_count(diagram),
+        cmanager.get_node_count(cdiagram)
+    ));
+
+    auto const negated = cmanager.negate(cdiagram);
+    auto const zero    = cmanager.constant(0);
+    auto const one     = cmanager.constant(1);
+    BOOST_REQUIRE(cmanager.negate(negated).equals(cdiagram));
+    BOOST_REQUIRE(cmanager.apply<AND>(cdiagram, negated).equals(zero));
+    BOOST_REQUIRE(cmanager.apply<OR>(cdiagram, negated).equals(one));
+    BOOST_REQUIRE(cmanager.apply<XOR>(cdiagram, negated).equals(one));
+    BOOST_REQUIRE(cmanager.apply<XOR>(cdiagram, cdiagram).equals(zero));
+    BOOST_REQUIRE(cmanager.apply<NAND>(cdiagram, cdiagram).equals(negated));
+    BOOST_REQUIRE(
+        cmanager.apply<XNOR>(cdiagram, zero).equals(negated)
+    );
+
+    auto const x0   = cmanager.variable(0);
+    auto const impl = cmanager.apply<IMPLIES>(cdiagram, x0);
+    auto const orn  = cmanager.apply<OR>(negated, x0);
+    BOOST_REQUIRE(impl.equals(orn));
+    BOOST_REQUIRE_LE(
+        cmanager.get_node_count(cdiagram),
+        manager.get_node_count(diagram)
+    );
+
+    cmanager.force_gc();
+    BOOST_REQUIRE_EQUAL(
+        cmanager.satisfy_count(1, cdiagram),
+        manager.satisfy_count(1, diagram)
+    );
+    BOOST_REQUIRE_EQUAL(
+        cmanager.satisfy_count(0, cdiagram),
+        manager.satisfy_count(0, diagram)
+    );
+    BOOST_REQUIRE_EQUAL(
+        cmanager.satisfy_count(1, negated),
+        manager.satisfy_count(0, diagram)
+    );
+
+    auto probs = std::vector<double>();
+    auto dist  = std::uniform_real_distribution<double>(0.0, 1.0);
+    for (auto i = 0; i < manager.get_var_count(); ++i)
+    {
+        probs.push_back(dist(rng_));
+    }
+
+    auto expectedProb = 0.0;
+    auto domainIt     = make_domain_iterator(manager);
+    auto evalIt       = tsl::evaluating_iterator(domainIt, expr);
+    auto evalEnd      = tsl::evaluating_iterator_sentinel();
+    while (evalIt != evalEnd)
+    {
+        auto const& vars = evalIt.get_var_vals();
+        BOOST_REQUIRE_EQUAL(*evalIt, cmanager.evaluate(cdiagram, vars));
+        BOOST_REQUIRE_EQUAL(1 - *evalIt, cmanager.evaluate(negated, vars));
+        if (*evalIt == 1)
+        {
+            auto prob = 1.0;
+            for (auto i = 0; i < ssize(vars); ++i)
+            {
+                auto const p  = probs[as_uindex(i)];
+                prob         *= vars[as_uindex(i)] == 1 ? p : 1.0 - p;
+            }
+            expectedProb += prob;
+        }
+        ++evalIt;
+    }
+    BOOST_TEST(
+        cmanager.calculate_probability(probs, cdiagram) == expectedProb,
+        boost::test_tools::tolerance(1e-9)
+    );
+    BOOST_TEST(
+        cmanager.calculate_probability(probs, negated) == 1.0 - expectedProb,
+        boost::test_tools::tolerance(1e-9)
+    );
+}
+
+BOOST_FIXTURE_TEST_CASE(zero_suppressed, bdd_fixture)
+{
+    using namespace teddy::ops;
+    auto expr     = make_expression(expressionSettings_, rng_);
+    auto manager  = make_manager(managerSettings_, rng_);
+    auto diagram  = tsl::make_diagram(expr, manager);
+    auto zmanager = bzdd_manager(
+        manager.get_var_count(),
+        managerSettings_.nodecount_,
+        manager.get_order()
+    );
+    auto const paths = zmanager.from_diagram(manager, diagram, 1);
+    auto const cuts  = zmanager.from_diagram(manager, diagram, 0);
+    auto const x0    = manager.variable(0);
+    auto const zx0   = zmanager.from_diagram(manager, x0, 1);
+
+    BOOST_REQUIRE_EQUAL(
+        zmanager.count(paths),
+        manager.satisfy_count(1, diagram)
+    );
+    BOOST_REQUIRE_EQUAL(
+        zmanager.count(cuts),
+        manager.satisfy_count(0, diagram)
+    );
+    BOOST_REQUIRE_EQUAL(zmanager.count(zmanager.empty()), 0);
+    BOOST_REQUIRE_EQUAL(zmanager.count(zmanager.base()), 1);
+    BOOST_REQUIRE(
+        zmanager.family_union(paths, cuts).equals(zmanager.from_diagram(
+            manager,
+            manager.constant(1),
+            1
+        ))
+    );
+    BOOST_REQUIRE(
+        zmanager.family_intersection(paths, cuts).equals(zmanager.empty())
+    );
+    BOOST_REQUIRE_EQUAL(
+        zmanager.count(zmanager.family_union(paths, zx0)),
+        manager.satisfy_count(1, manager.apply<OR>(diagram, x0))
+    );
+    BOOST_REQUIRE_EQUAL(
+        zmanager.count(zmanager.family_intersection(paths, zx0)),
+        manager.satisfy_count(1, manager.apply<AND>(diagram, x0))
+    );
+    BOOST_REQUIRE_EQUAL(
+        zmanager.count(zmanager.family_difference(paths, zx0)),
+        manager.satisfy_count(1, manager.apply<GREATER>(diagram, x0))
+    );
+
+    // The function is monotone, minimal path vector is a path vector
+    // such that decreasing any of its elements yields a cut vector.
+    auto const minimalPaths = zmanager.minimal(paths);
+    auto expectedMinimal    = int64 {0};
+    auto domainIt           = make_domain_iterator(manager);
+    auto evalIt             = tsl::evaluating_iterator(domainIt, expr);
+    auto evalEnd            = tsl::evaluating_iterator_sentinel();
+    while (evalIt != evalEnd)
+    {
+        auto vars = evalIt.get_var_vals();
+        BOOST_REQUIRE_EQUAL(*evalIt == 1, zmanager.contains(paths, vars));
+        BOOST_REQUIRE_EQUAL(*evalIt == 0, zmanager.contains(cuts, vars));
+        auto isMinimal = *evalIt == 1;
+        for (auto i = 0; isMinimal && i < ssize(vars); ++i)
+        {
+            if (vars[as_uindex(i)] == 1)
+            {
+                vars[as_uindex(i)] = 0;
+                isMinimal          = manager.evaluate(diagram, vars) == 0;
+                vars[as_uindex(i)] = 1;
+            }
+        }
+        expectedMinimal += isMinimal;
+        BOOST_REQUIRE_EQUAL(isMinimal, zmanager.contains(minimalPaths, vars));
+        ++evalIt;
+    }
+    BOOST_REQUIRE_EQUAL(zmanager.count(minimalPaths), expectedMinimal);
+
+    auto const enumerated
+        = zmanager.enumerate<std::vector<int32>>(minimalPaths);
+    BOOST_REQUIRE_EQUAL(ssize(enumerated), expectedMinimal);
+    for (auto const& vars : enumerated)
+    {
+        BOOST_REQUIRE_EQUAL(manager.evaluate(diagram, vars), 1);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 } // namespace teddy::tests
\ No newline at end of file
@@ -19,7 +19,10 @@
 
 #include <algorithm>
 #include <array>
+#include <cmath>
 #include <cstddef>
+#include <limits>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -221,6 +224,37 @@ BOOST_FIXTURE_TEST_CASE(probabilities_bss, teddy::tests::bss_fixture)
         actual[1] == expected[1],
         boost::test_tools::tolerance(FloatingTolerance)
     );
+
+    // Probabilities that decay in time, more than one block of times.
+    auto distVec = std::vector<probs::prob_dist>();
+    for (auto const prob : probVec)
+    {
+        distVec.emplace_back(probs::custom_dist(
+            [prob] (double const t) { return prob * std::exp(-0.1 * t); }
+        ));
+    }
+    auto times = std::vector<double>();
+    for (auto i = 0; i < 100; ++i)
+    {
+        times.push_back(0.1 * i);
+    }
+
+    auto const curve
+        = manager.calculate_availability_curve(distVec, diagram, times);
+    BOOST_REQUIRE_EQUAL(ssize(curve), ssize(times));
+    for (auto i = 0; i < ssize(times); ++i)
+    {
+        auto timeProbs = probVec;
+        for (auto& prob : timeProbs)
+        {
+            prob *= std::exp(-0.1 * times[as_uindex(i)]);
+        }
+        BOOST_TEST(
+            curve[as_uindex(i)]
+                == manager.calculate_probability(timeProbs, diagram),
+            boost::test_tools::tolerance(FloatingTolerance)
+        );
+    }
 }
 
 BOOST_FIXTURE_TEST_CASE_TEMPLATE(probabilities, Fixture, Fixtures, Fixture)
@@ -266,6 +300,59 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(probabilities, Fixture, Fixtures, Fixture)
             boost::test_tools::tolerance(FloatingTolerance)
         );
     }
+
+    auto const all = manager.calculate_state_probabilities(probs, diagram);
+    for (auto j = 0; j < Fixture::stateCount_; ++j)
+    {
+        BOOST_TEST(
+            (j < ssize(all) ? all[as_uindex(j)] : 0.0)
+                == expected[as_uindex(j)],
+            boost::test_tools::tolerance(FloatingTolerance)
+        );
+    }
+
+    auto const diagrams = std::vector<std::remove_const_t<decltype(diagram)>> {
+        diagram,
+        manager.get_cofactor(diagram, 0, 1),
+        manager.get_cofactor(diagram, 1, 0),
+        diagram
+    };
+    auto const allOfMany
+        = manager.calculate_state_probabilities(probs, diagrams);
+    auto const availabilities
+        = manager.calculate_availabilities(1, probs, diagrams);
+    BOOST_REQUIRE_EQUAL(ssize(allOfMany), ssize(diagrams));
+    for (auto i = 0; i < ssize(diagrams); ++i)
+    {
+        auto const& one   = diagrams[as_uindex(i)];
+        auto const& many  = allOfMany[as_uindex(i)];
+        auto const single = manager.calculate_state_probabilities(probs, one);
+        BOOST_REQUIRE_EQUAL(ssize(many), ssize(single));
+        for (auto j = 0; j < ssize(single); ++j)
+        {
+            BOOST_TEST(
+                many[as_uindex(j)] == single[as_uindex(j)],
+                boost::test_tools::tolerance(FloatingTolerance)
+            );
+        }
+        BOOST_TEST(
+            availabilities[as_uindex(i)]
+                == manager.calculate_availability(1, probs, one),
+            boost::test_tools::tolerance(FloatingTolerance)
+        );
+    }
+
+    for (auto j = 0; j < Fixture::stateCount_; ++j)
+    {
+        auto const samples
+            = manager.sample_satisfying(j, probs, diagram, Fixture::rng_, 100);
+        auto const sampleCount = expected[as_uindex(j)] > 0 ? 100 : 0;
+        BOOST_REQUIRE_EQUAL(ssize(samples), sampleCount);
+        for (auto const& sample : samples)
+        {
+            BOOST_REQUIRE_EQUAL(j, manager.evaluate(diagram, sample));
+        }
+    }
 }
 
 BOOST_FIXTURE_TEST_CASE_TEMPLATE(availabilities, Fixture, Fixtures, Fixture)
@@ -314,6 +401,58 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(availabilities, Fixture, Fixtures, Fixture)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(
+    availability_curve,
+    Fixture,
+    Fixtures,
+    Fixture
+)
+{
+    auto const expr
+        = make_expression(Fixture::expressionSettings_, Fixture::rng_);
+    auto manager       = make_manager(Fixture::managerSettings_, Fixture::rng_);
+    auto const diagram = tsl::make_diagram(expr, manager);
+    auto const probs   = make_probabilities(manager, Fixture::rng_);
+
+    // Probabilities that decay in time, more than one block of times.
+    auto dists = std::vector<std::vector<probs::prob_dist>>();
+    for (auto const& componentProbs : probs)
+    {
+        auto& componentDists = dists.emplace_back();
+        for (auto const prob : componentProbs)
+        {
+            componentDists.emplace_back(probs::custom_dist(
+                [prob] (double const t) { return prob * std::exp(-0.1 * t); }
+            ));
+        }
+    }
+    auto times = std::vector<double>();
+    for (auto i = 0; i < 100; ++i)
+    {
+        times.push_back(0.1 * i);
+    }
+
+    for (auto j = 1; j < Fixture::stateCount_; ++j)
+    {
+        auto const curve
+            = manager.calculate_availability_curve(j, dists, diagram, times);
+        BOOST_REQUIRE_EQUAL(ssize(curve), ssize(times));
+        for (auto i = 0; i < ssize(times); ++i)
+        {
+            auto timeDists      = dists;
+            auto const expected = manager.calculate_availability(
+                j,
+                probs::at_time(timeDists, times[as_uindex(i)]),
+                diagram
+            );
+            BOOST_TEST(
+                curve[as_uindex(i)] == expected,
+                boost::test_tools::tolerance(FloatingTolerance)
+            );
+        }
+    }
+}
+
 BOOST_FIXTURE_TEST_CASE_TEMPLATE(unavailabilities, Fixture, Fixtures, Fixture)
 {
     auto const expr
@@ -407,6 +546,7 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(
     for (auto systemState = 1; systemState < Fixture::stateCount_;
          ++systemState)
     {
+        auto const all = manager.structural_importances(systemState, diagram);
         for (auto varIndex = 0; varIndex < manager.get_var_count(); ++varIndex)
         {
             for (auto varVal = 1; varVal < domains[as_uindex(varIndex)];
@@ -429,6 +569,10 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(
                     expected == actual,
                     boost::test_tools::tolerance(FloatingTolerance)
                 );
+                BOOST_TEST(
+                    expected == all[as_uindex(varIndex)][as_uindex(varVal)],
+                    boost::test_tools::tolerance(FloatingTolerance)
+                );
             }
         }
     }
@@ -452,6 +596,8 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(
     for (auto systemState = 1; systemState < Fixture::stateCount_;
          ++systemState)
     {
+        auto const all
+            = manager.birnbaum_importances(systemState, probs, diagram);
         for (auto varIndex = 0; varIndex < manager.get_var_count(); ++varIndex)
         {
             for (auto varVal = 1;
@@ -476,6 +622,10 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(
                     expected == actual,
                     boost::test_tools::tolerance(FloatingTolerance)
                 );
+                BOOST_TEST(
+                    expected == all[as_uindex(varIndex)][as_uindex(varVal)],
+                    boost::test_tools::tolerance(FloatingTolerance)
+                );
             }
         }
     }
@@ -1305,6 +1455,133 @@ BOOST_DATA_TEST_CASE(system_test, systems, system)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(algebraic_diagrams, Fixture, Fixtures, Fixture)
+{
+    using namespace teddy::real_ops;
+    auto const expr
+        = make_expression(Fixture::expressionSettings_, Fixture::rng_);
+    auto manager  = make_manager(Fixture::managerSettings_, Fixture::rng_);
+    auto diagram  = tsl::make_diagram(expr, manager);
+    auto probs    = make_probabilities(manager, Fixture::rng_);
+    auto amanager = iadd_manager(
+        manager.get_var_count(),
+        10'000,
+        manager.get_domains(),
+        manager.get_order()
+    );
+
+    auto const values = amanager.from_diagram(manager, diagram);
+    auto expectedMean = 0.0;
+    manager.calculate_probabilities(probs, diagram);
+    for (auto j = 0; j < Fixture::stateCount_; ++j)
+    {
+        expectedMean += j * manager.get_probability(j);
+    }
+    BOOST_TEST(
+        amanager.expected_value(probs, values) == expectedMean,
+        boost::test_tools::tolerance(FloatingTolerance)
+    );
+
+    for (auto j = 1; j < Fixture::stateCount_; ++j)
+    {
+        auto const indicator = amanager.from_diagram(
+            manager,
+            diagram,
+            [j] (int32 const value) { return value >= j ? 1.0 : 0.0; }
+        );
+        auto const expected = manager.calculate_availability(j, probs, diagram);
+        BOOST_TEST(
+            amanager.expected_value(probs, indicator) == expected,
+            boost::test_tools::tolerance(FloatingTolerance)
+        );
+        BOOST_REQUIRE(
+            amanager.apply<TIMES>(indicator, indicator).equals(indicator)
+        );
+        BOOST_TEST(
+            amanager.expected_value(
+                probs,
+                amanager.apply<PLUS>(indicator, values)
+            ) == expected + expectedMean,
+            boost::test_tools::tolerance(FloatingTolerance)
+        );
+
+        // Availability as a function of the state of the first component.
+        auto availability = indicator;
+        for (auto i = 1; i < manager.get_var_count(); ++i)
+        {
+            availability = amanager.average(probs, availability, i);
+        }
+        BOOST_REQUIRE_LE(
+            amanager.get_node_count(availability),
+            1 + manager.get_domains()[0]
+        );
+        auto conditional = 0.0;
+        auto vars        = std::vector<int32>(
+            as_usize(manager.get_var_count()),
+            0
+        );
+        for (auto k = 0; k < manager.get_domains()[0]; ++k)
+        {
+            vars[0]              = k;
+            auto const cofactor  = amanager.get_cofactor(indicator, 0, k);
+            auto const available = amanager.evaluate(availability, vars);
+            BOOST_TEST(
+                amanager.expected_value(probs, cofactor) == available,
+                boost::test_tools::tolerance(FloatingTolerance)
+            );
+            conditional += probs[0][as_uindex(k)] * available;
+        }
+        BOOST_TEST(
+            conditional == expected,
+            boost::test_tools::tolerance(FloatingTolerance)
+        );
+        amanager.force_gc();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(algebraic_terminals)
+{
+    using namespace teddy::real_ops;
+    auto manager   = badd_manager(2, 1'000);
+    auto const nan = std::numeric_limits<double>::quiet_NaN();
+    BOOST_REQUIRE(manager.constant(nan).equals(manager.constant(-nan)));
+    BOOST_REQUIRE(manager.constant(nan).equals(
+        manager.apply<TIMES>(manager.constant(nan), manager.variable(0))
+    ));
+    BOOST_REQUIRE(manager.constant(-0.0).equals(manager.constant(0.0)));
+    auto const sum
+        = manager.apply<PLUS>(manager.constant(0.1), manager.constant(0.2));
+    BOOST_REQUIRE(sum.equals(manager.constant(0.3)));
+
+    // Unused values are dropped and their terminals reused.
+    auto const x0 = manager.variable(0);
+    manager.force_gc();
+    auto const baseCount = manager.get_node_count();
+    for (auto i = 0; i < 1'000; ++i)
+    {
+        static_cast<void>(manager.constant(i + 0.5));
+    }
+    manager.force_gc();
+    BOOST_REQUIRE_EQUAL(manager.get_node_count(), baseCount);
+
+    auto const shifted = manager.apply<PLUS>(x0, manager.constant(10.0));
+    auto vars          = std::vector<int32> {1, 0};
+    BOOST_REQUIRE_EQUAL(manager.evaluate(shifted, vars), 11.0);
+    BOOST_REQUIRE_EQUAL(manager.evaluate(x0, vars), 1.0);
+
+    // Averages with different probabilities are not mixed up.
+    auto const both = manager.apply<PLUS>(x0, manager.variable(1));
+    for (auto const p : {0.25, 0.75})
+    {
+        auto const probs = std::vector<std::vector<double>> {
+            {0.5, 0.5},
+            {1.0 - p, p}
+        };
+        auto const averaged = manager.average(probs, both, 1);
+        BOOST_REQUIRE_EQUAL(manager.evaluate(averaged, vars), 1.0 + p);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace teddy::tests
\ No newline at end of file